@@ -0,0 +1,56 @@
+#include <memory>
+#include <sstream>
+#include "benchmark.hpp"
+#include "ann.hpp"
+#include "philox.hpp"
+
+
+typedef ANN<3, 2> BenchANN;
+
+static BenchmarkSetup ProcessSetup( std::size_t hidden, std::size_t layers )
+{
+	return [=]() -> BenchmarkBody
+	{
+		const BenchANN::format_type format(hidden, layers);
+		Philox4x32 rng(1);
+		BenchANN::weight_list weights = BenchANN::weight_list::New(format.weights_count());
+		BenchANN::random_weights(format, rng, weights.data());
+
+		std::shared_ptr<BenchANN> ann(new BenchANN(format, std::move(weights)));
+		std::shared_ptr<BenchANN::data_type> data(new BenchANN::data_type(format));
+		for(std::size_t idx = 0; idx < format.input_neurons(); ++idx)
+			data->in[idx] = 0.25f * float(idx + 1);
+
+		return [ann, data](std::size_t iterations)
+		{
+			for(std::size_t it = 0; it < iterations; ++it)
+			{
+				ann->process(*data);
+				KeepValue(data->out[0]);
+			}
+		};
+	};
+}
+
+static bool RegisterAnnBenchmarks()
+{
+	static const std::size_t HIDDEN[] = {4, 16, 64, 256};
+
+	for(std::size_t layers = 0; layers <= 4; ++layers)
+	{
+		for(std::size_t hidden : HIDDEN)
+		{
+			std::ostringstream name;
+			name << "ann/process/l" << layers << "/h" << hidden;
+			const BenchANN::format_type format(hidden, layers);
+			RegisterBenchmark(name.str(), double(format.weights_count()), "weights", ProcessSetup(hidden, layers));
+
+			// without hidden layers the hidden size does not matter
+			if(layers == 0)
+				break;
+		}
+	}
+	return true;
+}
+
+static const bool ANN_BENCHMARKS = RegisterAnnBenchmarks();
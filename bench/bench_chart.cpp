@@ -0,0 +1,52 @@
+#include <memory>
+#include "benchmark.hpp"
+#include "chart_model.hpp"
+#include "chart_generator.hpp"
+
+
+// the charts of the training, 20 seconds with 30 ticks each
+static const std::size_t TICK_COUNT = 600;
+static const std::size_t LARGE_TICK_COUNT = 1 << 20;
+static const std::size_t WALK_COUNT = 64;
+
+
+static BenchmarkSetup GenerateSetup( std::size_t tick_count )
+{
+	return [=]() -> BenchmarkBody
+	{
+		std::shared_ptr<ChartModel> model(new ChartModel(0.0f, 10.0f, 0.25f, tick_count));
+
+		return [model](std::size_t iterations)
+		{
+			for(std::size_t it = 0; it < iterations; ++it)
+			{
+				model->generate(std::uint64_t(it), 0);
+				KeepValue(model->values()[0]);
+			}
+		};
+	};
+}
+
+static BenchmarkBody WalksSetup()
+{
+	std::shared_ptr<std::vector<float>> values(new std::vector<float>(TICK_COUNT * WALK_COUNT));
+
+	return [values](std::size_t iterations)
+	{
+		for(std::size_t it = 0; it < iterations; ++it)
+		{
+			GenerateWalks(values->data(), TICK_COUNT, TICK_COUNT, 0, WALK_COUNT, 0.0f, 10.0f, 0.25f, std::uint64_t(it));
+			KeepValue((*values)[0]);
+		}
+	};
+}
+
+static bool RegisterChartBenchmarks()
+{
+	RegisterBenchmark("chart_model/generate/600", double(TICK_COUNT), "ticks", GenerateSetup(TICK_COUNT));
+	RegisterBenchmark("chart_model/generate/1M", double(LARGE_TICK_COUNT), "ticks", GenerateSetup(LARGE_TICK_COUNT));
+	RegisterBenchmark("chart_generator/walks_x64", double(TICK_COUNT * WALK_COUNT), "ticks", WalksSetup);
+	return true;
+}
+
+static const bool CHART_BENCHMARKS = RegisterChartBenchmarks();
@@ -0,0 +1,57 @@
+#include <memory>
+#include "benchmark.hpp"
+#include "thread_pool.hpp"
+
+
+static const std::size_t TASK_BURST = 64;
+
+
+static BenchmarkBody RoundTripSetup()
+{
+	std::shared_ptr<ThreadPool> pool(new ThreadPool());
+
+	return [pool](std::size_t iterations)
+	{
+		for(std::size_t it = 0; it < iterations; ++it)
+		{
+			pool->post([]{});
+			pool->complete();
+		}
+	};
+}
+
+static BenchmarkBody BurstSetup()
+{
+	std::shared_ptr<ThreadPool> pool(new ThreadPool());
+
+	return [pool](std::size_t iterations)
+	{
+		for(std::size_t it = 0; it < iterations; ++it)
+		{
+			for(std::size_t task = 0; task < TASK_BURST; ++task)
+				pool->post([]{});
+			pool->complete();
+		}
+	};
+}
+
+static BenchmarkBody ParallelForSetup()
+{
+	std::shared_ptr<ThreadPool> pool(new ThreadPool());
+
+	return [pool](std::size_t iterations)
+	{
+		for(std::size_t it = 0; it < iterations; ++it)
+			pool->parallel_for(0, TASK_BURST, 1, [](std::size_t first, std::size_t){ KeepValue(first); });
+	};
+}
+
+static bool RegisterThreadPoolBenchmarks()
+{
+	RegisterBenchmark("thread_pool/post_complete", 1.0, "tasks", RoundTripSetup);
+	RegisterBenchmark("thread_pool/post_complete_x64", double(TASK_BURST), "tasks", BurstSetup);
+	RegisterBenchmark("thread_pool/parallel_for_x64", double(TASK_BURST), "chunks", ParallelForSetup);
+	return true;
+}
+
+static const bool THREAD_POOL_BENCHMARKS = RegisterThreadPoolBenchmarks();
@@ -0,0 +1,94 @@
+#include <memory>
+#include "benchmark.hpp"
+#include "ai_test.hpp"
+
+
+static const std::size_t POPULATION_SIZE = 100;
+static const std::size_t CORPUS_SIZE = 16;
+static const std::size_t SCENARIO_COUNT = 8;
+// the charts of the training, 20 seconds with 30 ticks each
+static const std::size_t TICK_COUNT = 600;
+static const std::uint64_t SEED = 1;
+
+
+// a processed first generation on a small corpus, shared by the benchmarks of one setup
+struct TrainingFixture
+{
+	TrainingFixture()
+		: corpus(0.0f, 10.0f, 0.25f, TICK_COUNT, CORPUS_SIZE, SEED, &pool)
+		, first_arena(AiFormat.weights_count(), POPULATION_SIZE)
+		, second_arena(AiFormat.weights_count(), POPULATION_SIZE)
+		, selection(CreateSelection(SelectionSettings()))
+	{
+		settings.scenario_count = SCENARIO_COUNT;
+		generation.reset(new Generation(POPULATION_SIZE, SEED, first_arena, pool));
+		generation->process(pool, corpus, settings);
+	}
+
+	ThreadPool pool;
+	ChartCorpus corpus;
+	GenomeArena first_arena;
+	GenomeArena second_arena;
+	std::unique_ptr<Selection> selection;
+	EvaluationSettings settings;
+	std::unique_ptr<Generation> generation;
+};
+
+
+static BenchmarkBody BreedSetup()
+{
+	std::shared_ptr<TrainingFixture> fixture(new TrainingFixture());
+
+	return [fixture](std::size_t iterations)
+	{
+		for(std::size_t it = 0; it < iterations; ++it)
+		{
+			Generation child(SEED, fixture->generation, fixture->second_arena, *fixture->selection, fixture->pool);
+			KeepValue(child);
+		}
+	};
+}
+
+static BenchmarkBody EvaluateSetup()
+{
+	std::shared_ptr<TrainingFixture> fixture(new TrainingFixture());
+
+	return [fixture](std::size_t iterations)
+	{
+		const Entity entity(fixture->first_arena.genome(0));
+		const ChartModel& chart = fixture->corpus.chart(0);
+		for(std::size_t it = 0; it < iterations; ++it)
+		{
+			const float fitness = entity.evaluate(&chart);
+			KeepValue(fitness);
+		}
+	};
+}
+
+static BenchmarkSetup ProcessSetup( EvaluationSettings::Mode mode )
+{
+	return [=]() -> BenchmarkBody
+	{
+		std::shared_ptr<TrainingFixture> fixture(new TrainingFixture());
+		fixture->settings.mode = mode;
+
+		return [fixture](std::size_t iterations)
+		{
+			for(std::size_t it = 0; it < iterations; ++it)
+				fixture->generation->process(fixture->pool, fixture->corpus, fixture->settings);
+		};
+	};
+}
+
+static bool RegisterTrainingBenchmarks()
+{
+	const double entity_ticks = double(POPULATION_SIZE * SCENARIO_COUNT * TICK_COUNT);
+
+	RegisterBenchmark("generation/breed", double(POPULATION_SIZE), "children", BreedSetup);
+	RegisterBenchmark("entity/evaluate", double(TICK_COUNT), "ticks", EvaluateSetup);
+	RegisterBenchmark("generation/process/batched", entity_ticks, "entity ticks", ProcessSetup(EvaluationSettings::Batched));
+	RegisterBenchmark("generation/process/entity", entity_ticks, "entity ticks", ProcessSetup(EvaluationSettings::PerEntity));
+	return true;
+}
+
+static const bool TRAINING_BENCHMARKS = RegisterTrainingBenchmarks();
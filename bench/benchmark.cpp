@@ -0,0 +1,201 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include "benchmark.hpp"
+
+
+// Runs the registered microbenchmarks of the core kernels.
+// Build with -DCMAKE_BUILD_TYPE=Release, the numbers of a debug build are meaningless.
+
+
+std::vector<Benchmark>& Benchmarks()
+{
+	static std::vector<Benchmark> benchmarks;
+	return benchmarks;
+}
+
+void RegisterBenchmark( const std::string& name, double items_per_op, const std::string& item_name, BenchmarkSetup setup )
+{
+	Benchmark benchmark;
+	benchmark.name = name;
+	benchmark.items_per_op = items_per_op;
+	benchmark.item_name = item_name;
+	benchmark.setup = setup;
+	Benchmarks().push_back(benchmark);
+}
+
+
+struct BenchmarkSettings
+{
+	BenchmarkSettings()
+		: samples(15)
+		, sample_time(0.02)
+		, list(false)
+	{
+	}
+
+	std::string filter;
+	std::size_t samples;
+	// seconds
+	double sample_time;
+	bool list;
+};
+
+struct BenchmarkResult
+{
+	std::size_t iterations;
+	double median_ns;
+	double min_ns;
+	// median absolute deviation relative to the median
+	double deviation;
+};
+
+
+static double Seconds( const BenchmarkBody& body, std::size_t iterations )
+{
+	using namespace std::chrono;
+	const auto start = steady_clock::now();
+	body(iterations);
+	return duration_cast<duration<double>>(steady_clock::now() - start).count();
+}
+
+static double Median( std::vector<double> values )
+{
+	const std::size_t mid = values.size() / 2;
+	std::nth_element(values.begin(), values.begin() + mid, values.end());
+	return values[mid];
+}
+
+static BenchmarkResult Measure( const BenchmarkBody& body, const BenchmarkSettings& settings )
+{
+	// warm up the caches and find the iterations that fill one sample
+	std::size_t iterations = 1;
+	double seconds = Seconds(body, iterations);
+	while(seconds < settings.sample_time && iterations < (std::size_t(1) << 40))
+	{
+		const double factor = seconds > 0.0? std::min(10.0, 1.2 * settings.sample_time / seconds) : 10.0;
+		iterations = std::max(iterations + 1, std::size_t(double(iterations) * factor));
+		seconds = Seconds(body, iterations);
+	}
+
+	std::vector<double> samples;
+	for(std::size_t idx = 0; idx < settings.samples; ++idx)
+		samples.push_back(Seconds(body, iterations) * 1e9 / double(iterations));
+
+	BenchmarkResult result;
+	result.iterations = iterations;
+	result.median_ns = Median(samples);
+	result.min_ns = *std::min_element(samples.begin(), samples.end());
+
+	std::vector<double> deviations;
+	for(double sample : samples)
+		deviations.push_back(std::abs(sample - result.median_ns));
+	result.deviation = result.median_ns > 0.0? Median(deviations) / result.median_ns : 0.0;
+	return result;
+}
+
+static std::string FormatRate( double per_second )
+{
+	static const char* const PREFIXES[] = {"", "k", "M", "G", "T"};
+	std::size_t prefix = 0;
+	while(per_second >= 1000.0 && prefix + 1 < sizeof(PREFIXES) / sizeof(PREFIXES[0]))
+	{
+		per_second /= 1000.0;
+		++prefix;
+	}
+
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(2) << per_second << " " << PREFIXES[prefix];
+	return out.str();
+}
+
+static void PrintUsage()
+{
+	std::cerr << "usage: bench [options] [filter]\n"
+		<< "  filter             runs only the benchmarks whose name contains it\n"
+		<< "  --samples N        samples per benchmark (default 15)\n"
+		<< "  --sample-time MS   milliseconds per sample (default 20)\n"
+		<< "  --list             prints the benchmarks without running them\n";
+}
+
+static bool ParseArguments( int argc, char** argv, BenchmarkSettings& settings )
+{
+	for(int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if(arg == "--list")
+		{
+			settings.list = true;
+		}else if(arg == "--samples" && i + 1 < argc)
+		{
+			settings.samples = std::size_t(std::atol(argv[++i]));
+		}else if(arg == "--sample-time" && i + 1 < argc)
+		{
+			settings.sample_time = std::atof(argv[++i]) / 1000.0;
+		}else if(arg.compare(0, 2, "--") != 0 && settings.filter.empty())
+		{
+			settings.filter = arg;
+		}else{
+			return false;
+		}
+	}
+
+	return settings.samples > 0 && settings.sample_time > 0.0;
+}
+
+
+int main( int argc, char** argv )
+{
+	BenchmarkSettings settings;
+	if(!ParseArguments(argc, argv, settings))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+#ifndef NDEBUG
+	std::cerr << "warning: assertions are enabled, build with -DCMAKE_BUILD_TYPE=Release for meaningful numbers" << std::endl;
+#endif
+
+	const std::vector<Benchmark>& benchmarks = Benchmarks();
+
+	std::size_t name_width = 0;
+	for(const Benchmark& benchmark : benchmarks)
+		name_width = std::max(name_width, benchmark.name.size());
+
+	if(!settings.list)
+	{
+		std::cout << std::left << std::setw(name_width) << "benchmark" << std::right
+			<< std::setw(14) << "ns/op" << std::setw(9) << "mad" << std::setw(14) << "min ns/op"
+			<< std::setw(12) << "iterations" << "   throughput" << std::endl;
+	}
+
+	for(const Benchmark& benchmark : benchmarks)
+	{
+		if(benchmark.name.find(settings.filter) == std::string::npos)
+			continue;
+
+		if(settings.list)
+		{
+			std::cout << benchmark.name << std::endl;
+			continue;
+		}
+
+		const BenchmarkBody body = benchmark.setup();
+		const BenchmarkResult result = Measure(body, settings);
+
+		std::cout << std::left << std::setw(name_width) << benchmark.name << std::right << std::fixed
+			<< std::setw(14) << std::setprecision(1) << result.median_ns
+			<< std::setw(8) << std::setprecision(1) << result.deviation * 100.0 << "%"
+			<< std::setw(14) << std::setprecision(1) << result.min_ns
+			<< std::setw(12) << result.iterations
+			<< "   " << FormatRate(benchmark.items_per_op * 1e9 / result.median_ns) << benchmark.item_name << "/s" << std::endl;
+	}
+
+	return 0;
+}
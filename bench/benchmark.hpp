@@ -0,0 +1,45 @@
+#pragma once
+#ifndef _BENCHMARK_HPP
+#define _BENCHMARK_HPP
+
+#include <string>
+#include <vector>
+#include <functional>
+
+
+// Minimal microbenchmark harness.
+// A benchmark is set up once and then runs in samples of a calibrated number of iterations,
+// so that one sample takes about the sample time. The median of the samples is reported
+// with the median absolute deviation, which a few disturbed samples do not shift.
+
+// runs the measured operation iterations times
+typedef std::function<void(std::size_t iterations)> BenchmarkBody;
+// prepares the data of a benchmark, only called if the benchmark is run
+typedef std::function<BenchmarkBody()> BenchmarkSetup;
+
+struct Benchmark
+{
+	std::string name;
+	// what one operation processes, for the throughput, e.g. 600 "ticks"
+	double items_per_op;
+	std::string item_name;
+	BenchmarkSetup setup;
+};
+
+std::vector<Benchmark>& Benchmarks();
+void RegisterBenchmark(const std::string& name, double items_per_op, const std::string& item_name, BenchmarkSetup setup);
+
+// keeps the compiler from optimizing a result away
+template<typename T>
+inline void KeepValue(const T& value)
+{
+#if defined(__GNUC__)
+	asm volatile("" : : "g"(&value) : "memory");
+#else
+	static volatile char sink;
+	sink = *reinterpret_cast<const volatile char*>(&value);
+#endif
+}
+
+
+#endif
@@ -0,0 +1,378 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include "ai_test.hpp"
+
+
+// End-to-end throughput of the training loop: runs a fixed number of generations headless
+// with a fixed seed for every thread count, writes a json report and optionally compares it
+// with a baseline report. Exits with 2 on a regression and with 3 if the thread count
+// changed the training results, which must never happen.
+
+
+struct BenchSettings
+{
+	BenchSettings()
+		: generations(20)
+		, warmup(2)
+		, seed(1)
+		, tolerance(0.1)
+	{
+		training.population_size = 100;
+	}
+
+	std::size_t generations;
+	std::size_t warmup;
+	unsigned int seed;
+	std::vector<std::size_t> thread_counts;
+	TrainingSettings training;
+	std::string json_path;
+	std::string baseline_path;
+	// allowed relative slowdown against the baseline
+	double tolerance;
+};
+
+struct RunResult
+{
+	RunResult()
+		: threads(0)
+		, seconds(0.0)
+		, generations_per_second(0.0)
+		, entity_ticks_per_second(0.0)
+		, speedup(0.0)
+		, max_fitness(0.0f)
+		, avg_fitness(0.0f)
+	{
+	}
+
+	std::size_t threads;
+	double seconds;
+	double generations_per_second;
+	double entity_ticks_per_second;
+	// against the first run
+	double speedup;
+	float max_fitness;
+	float avg_fitness;
+};
+
+
+// times the generations after the warmup
+class TimingObserver: public AiTestObserver
+{
+public:
+	TimingObserver(std::size_t warmup)
+		: mWarmup(warmup)
+		, mStart(std::chrono::steady_clock::now())
+		, mEnd(mStart)
+		, mGenerations(0)
+		, mSimulatedTicks(0)
+	{
+	}
+
+	virtual void generation_done( const PopulationStats& stats )
+	{
+		const auto now = std::chrono::steady_clock::now();
+		if(stats.generation + 1 == mWarmup)
+		{
+			mStart = now;
+		}else if(stats.generation >= mWarmup){
+			mEnd = now;
+			++mGenerations;
+			mSimulatedTicks += stats.simulated_ticks;
+		}
+		mLastStats = stats;
+	}
+
+	RunResult result() const
+	{
+		using namespace std::chrono;
+		RunResult result;
+		result.seconds = duration_cast<duration<double>>(mEnd - mStart).count();
+		if(result.seconds > 0.0)
+		{
+			result.generations_per_second = double(mGenerations) / result.seconds;
+			result.entity_ticks_per_second = double(mSimulatedTicks) / result.seconds;
+		}
+		result.max_fitness = mLastStats.max_fitness;
+		result.avg_fitness = mLastStats.avg_fitness;
+		return result;
+	}
+
+private:
+	const std::size_t mWarmup;
+	std::chrono::steady_clock::time_point mStart;
+	std::chrono::steady_clock::time_point mEnd;
+	std::size_t mGenerations;
+	std::uint64_t mSimulatedTicks;
+	PopulationStats mLastStats;
+};
+
+
+static RunResult RunTraining( const BenchSettings& settings, std::size_t threads )
+{
+	TrainingSettings training = settings.training;
+	training.seed = settings.seed;
+	training.thread_count = threads;
+	training.generation_limit = settings.warmup + settings.generations;
+
+	TimingObserver observer(settings.warmup);
+	AiTest test(training, &observer);
+	test.run();
+
+	RunResult result = observer.result();
+	result.threads = threads;
+	return result;
+}
+
+static void WriteReport( std::ostream& out, const BenchSettings& settings, const std::vector<RunResult>& runs )
+{
+	const TrainingSettings& training = settings.training;
+	out << "{\n"
+		<< "  \"benchmark\": \"train-bench\",\n"
+		<< "  \"seed\": " << settings.seed << ",\n"
+		<< "  \"generations\": " << settings.generations << ",\n"
+		<< "  \"warmup\": " << settings.warmup << ",\n"
+		<< "  \"population\": " << training.population_size << ",\n"
+		<< "  \"corpus_size\": " << training.corpus_size << ",\n"
+		<< "  \"scenarios\": " << training.evaluation.scenario_count << ",\n"
+		<< "  \"mode\": \"" << (training.evaluation.mode == EvaluationSettings::Batched? "batched" : "entity") << "\",\n"
+		<< "  \"topology\": {\"inputs\": " << AiFormat.input_neurons() << ", \"hidden\": " << AiFormat.hidden_neurons()
+			<< ", \"layers\": " << AiFormat.layer_count() << ", \"outputs\": " << AiFormat.output_neurons() << "},\n"
+		<< "  \"hardware_threads\": " << ThreadPool::default_size() << ",\n"
+		<< "  \"runs\": [\n";
+
+	// one run per line, the baseline reader depends on it
+	for(std::size_t idx = 0; idx < runs.size(); ++idx)
+	{
+		const RunResult& run = runs[idx];
+		out << "    {\"threads\": " << run.threads
+			<< ", \"seconds\": " << std::setprecision(6) << run.seconds
+			<< ", \"generations_per_second\": " << run.generations_per_second
+			<< ", \"entity_ticks_per_second\": " << run.entity_ticks_per_second
+			<< ", \"speedup\": " << run.speedup
+			<< ", \"max_fitness\": " << std::setprecision(9) << run.max_fitness
+			<< ", \"avg_fitness\": " << run.avg_fitness << "}"
+			<< (idx + 1 < runs.size()? "," : "") << "\n";
+	}
+	out << "  ]\n}\n";
+}
+
+static bool FindNumber( const std::string& line, const std::string& key, double& value )
+{
+	const std::string pattern = "\"" + key + "\":";
+	const std::size_t pos = line.find(pattern);
+	if(pos == std::string::npos)
+		return false;
+	value = std::strtod(line.c_str() + pos + pattern.size(), nullptr);
+	return true;
+}
+
+// reads the runs of a report written by WriteReport
+static std::vector<RunResult> ReadRuns( const std::string& path )
+{
+	std::ifstream in(path.c_str());
+	if(!in)
+		throw std::runtime_error("can not open baseline " + path);
+
+	std::vector<RunResult> runs;
+	std::string line;
+	while(std::getline(in, line))
+	{
+		double threads, value;
+		if(!FindNumber(line, "threads", threads))
+			continue;
+
+		RunResult run;
+		run.threads = std::size_t(threads);
+		if(FindNumber(line, "generations_per_second", value))
+			run.generations_per_second = value;
+		if(FindNumber(line, "entity_ticks_per_second", value))
+			run.entity_ticks_per_second = value;
+		if(FindNumber(line, "speedup", value))
+			run.speedup = value;
+		if(FindNumber(line, "max_fitness", value))
+			run.max_fitness = float(value);
+		if(FindNumber(line, "avg_fitness", value))
+			run.avg_fitness = float(value);
+		runs.push_back(run);
+	}
+	return runs;
+}
+
+// returns false if a run is slower or scales worse than its baseline
+static bool CompareWithBaseline( const std::vector<RunResult>& runs, const std::vector<RunResult>& baseline, double tolerance )
+{
+	bool passed = true;
+	bool same_results = true;
+	for(const RunResult& run : runs)
+	{
+		auto base = std::find_if(baseline.begin(), baseline.end(), [&](const RunResult& b){ return b.threads == run.threads; });
+		if(base == baseline.end())
+		{
+			std::cerr << "threads " << run.threads << ": not in the baseline" << std::endl;
+			continue;
+		}
+
+		const double ratio = base->generations_per_second > 0.0? run.generations_per_second / base->generations_per_second : 1.0;
+		const double scaling = base->speedup > 0.0? run.speedup / base->speedup : 1.0;
+		const bool slower = ratio < 1.0 - tolerance;
+		const bool worse_scaling = scaling < 1.0 - tolerance;
+
+		std::cerr << "threads " << run.threads << ": " << std::fixed << std::setprecision(1)
+			<< (ratio - 1.0) * 100.0 << "% generations/s, " << (scaling - 1.0) * 100.0 << "% speedup"
+			<< (slower? "  REGRESSION" : "") << (worse_scaling? "  SCALING REGRESSION" : "") << std::endl;
+
+		passed = passed && !slower && !worse_scaling;
+		same_results = same_results && std::abs(run.max_fitness - base->max_fitness) <= 1e-6f * std::max(1.0f, std::abs(base->max_fitness));
+	}
+
+	if(!same_results)
+		std::cerr << "note: the fitness differs from the baseline, the training itself changed" << std::endl;
+	return passed;
+}
+
+
+static std::vector<std::size_t> ParseThreadCounts( const std::string& list )
+{
+	std::vector<std::size_t> counts;
+	std::istringstream in(list);
+	std::string item;
+	while(std::getline(in, item, ','))
+	{
+		const std::size_t count = std::size_t(std::atol(item.c_str()));
+		if(count == 0)
+			return std::vector<std::size_t>();
+		counts.push_back(count);
+	}
+	return counts;
+}
+
+static std::vector<std::size_t> DefaultThreadCounts()
+{
+	// 1, 2, 4, ... and all hardware threads
+	std::vector<std::size_t> counts;
+	const std::size_t hardware = ThreadPool::default_size();
+	for(std::size_t count = 1; count < hardware; count *= 2)
+		counts.push_back(count);
+	counts.push_back(hardware);
+	return counts;
+}
+
+static void PrintUsage()
+{
+	std::cerr << "usage: train-bench [options]\n"
+		<< "  --generations N      measured generations per run (default 20)\n"
+		<< "  --warmup N           generations before the measurement (default 2)\n"
+		<< "  --population N       entities per generation (default 100)\n"
+		<< "  --scenarios N        charts every entity is evaluated on (default 8)\n"
+		<< "  --mode M             batched or entity (default batched)\n"
+		<< "  --threads LIST       comma separated thread counts (default 1, 2, 4, ... hardware threads)\n"
+		<< "  --seed S             seed of the corpus and the breeding (default 1)\n"
+		<< "  --json PATH          writes the report to PATH instead of stdout\n"
+		<< "  --baseline PATH      compares with a previous report\n"
+		<< "  --tolerance T        allowed relative slowdown against the baseline (default 0.1)\n";
+}
+
+static bool ParseArguments( int argc, char** argv, BenchSettings& settings )
+{
+	for(int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if(i + 1 >= argc)
+			return false;
+		const std::string value = argv[++i];
+
+		if(arg == "--generations")
+			settings.generations = std::size_t(std::atol(value.c_str()));
+		else if(arg == "--warmup")
+			settings.warmup = std::size_t(std::atol(value.c_str()));
+		else if(arg == "--population")
+			settings.training.population_size = std::size_t(std::atol(value.c_str()));
+		else if(arg == "--scenarios")
+			settings.training.evaluation.scenario_count = std::size_t(std::atol(value.c_str()));
+		else if(arg == "--mode" && (value == "batched" || value == "entity"))
+			settings.training.evaluation.mode = value == "batched"? EvaluationSettings::Batched : EvaluationSettings::PerEntity;
+		else if(arg == "--threads")
+			settings.thread_counts = ParseThreadCounts(value);
+		else if(arg == "--seed")
+			settings.seed = unsigned(std::strtoul(value.c_str(), nullptr, 10));
+		else if(arg == "--json")
+			settings.json_path = value;
+		else if(arg == "--baseline")
+			settings.baseline_path = value;
+		else if(arg == "--tolerance")
+			settings.tolerance = std::atof(value.c_str());
+		else
+			return false;
+	}
+
+	if(settings.thread_counts.empty())
+		settings.thread_counts = DefaultThreadCounts();
+	return settings.generations > 0 && settings.warmup > 0 && settings.seed != 0 && settings.training.population_size > 0;
+}
+
+
+int main( int argc, char** argv )
+{
+	BenchSettings settings;
+	if(!ParseArguments(argc, argv, settings))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+#ifndef NDEBUG
+	std::cerr << "warning: assertions are enabled, build with -DCMAKE_BUILD_TYPE=Release for meaningful numbers" << std::endl;
+#endif
+
+	try
+	{
+		std::vector<RunResult> runs;
+		for(std::size_t threads : settings.thread_counts)
+		{
+			RunResult run = RunTraining(settings, threads);
+			run.speedup = runs.empty() || runs.front().generations_per_second <= 0.0? 1.0 : run.generations_per_second / runs.front().generations_per_second;
+			runs.push_back(run);
+
+			std::cerr << "threads " << run.threads << ": " << std::fixed << std::setprecision(2)
+				<< run.generations_per_second << " gens/s, " << run.entity_ticks_per_second / 1e6 << " M entity ticks/s, speedup "
+				<< run.speedup << std::endl;
+		}
+
+		if(settings.json_path.empty())
+		{
+			WriteReport(std::cout, settings, runs);
+		}else{
+			std::ofstream out(settings.json_path.c_str());
+			if(!out)
+				throw std::runtime_error("can not write " + settings.json_path);
+			WriteReport(out, settings, runs);
+		}
+
+		// the training is seeded, so the thread count must not change the results
+		for(const RunResult& run : runs)
+		{
+			if(run.max_fitness != runs.front().max_fitness || run.avg_fitness != runs.front().avg_fitness)
+			{
+				std::cerr << "train-bench: the results depend on the thread count" << std::endl;
+				return 3;
+			}
+		}
+
+		if(!settings.baseline_path.empty() && !CompareWithBaseline(runs, ReadRuns(settings.baseline_path), settings.tolerance))
+			return 2;
+
+	}catch(const std::exception& e)
+	{
+		std::cerr << "train-bench: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
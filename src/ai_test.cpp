@@ -0,0 +1,393 @@
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <chrono>
+#include <random>
+#include <functional>
+#include <cassert>
+#include "ai_test.hpp"
+#include "trader_batch.hpp"
+#include "utils.hpp"
+
+#define GEN_COUNT 100
+#define BATCH_SIZE 32
+#define ENTITY_CHUNK_SIZE 8
+#define CORPUS_SIZE 64
+#define SCENARIO_COUNT 8
+#define BREED_CHUNK_SIZE 16
+
+const ANNFormat<3, 2> AiFormat(5, 3);
+
+static const float MIN_CHART_VALUE = 0;
+static const float MAX_CHART_VALUE = 10;
+static const float CHART_IN_SECONDS = 20.0f;
+static const float TICKS_PER_SECOND = 30.0f;
+static const float CHART_VOLATILITY = 0.25f;
+
+// stream of the selection tables, the children use the streams 0 .. population size - 1
+static const std::uint32_t SELECTION_STREAM = 0xffffffff;
+
+
+EvaluationSettings::EvaluationSettings()
+	: mode(Batched)
+	, scenario_count(SCENARIO_COUNT)
+	, aggregation(Mean)
+	, quantile(0.25f)
+	, normalize_fitness(false)
+{
+}
+
+TrainingSettings::TrainingSettings()
+	: population_size(GEN_COUNT)
+	, generation_limit(0)
+	, thread_count(0)
+	, seed(0)
+	, corpus_size(CORPUS_SIZE)
+{
+}
+
+/////////////////////////////////////////// Entity ///////////////////////////////////////////
+Entity::Entity( const float* genome )
+	: mGenome(genome)
+	, mFitness(0)
+{
+}
+
+float Entity::evaluate( const ChartModel* model ) const
+{
+	TickChart chart(model);
+	SimulationTrader trader(0.0f);
+
+	// AiFormat is known at compile time, so the unrolled network is used here
+	assert(MyStaticANN::format() == AiFormat);
+	MyStaticANN ann(mGenome);
+	MyStaticANN::input_type input;
+
+	const ChartCursor& cursor = chart.cursor();
+	while(!cursor.is_done())
+	{
+		fill_input(cursor, trader, input.data(), 1);
+
+		auto output = ann.process(input);
+		act(trader, cursor.value(), output[0], output[1]);
+
+		chart.walk_tick();
+	}
+
+	return score(trader.capital());
+}
+
+float Entity::score( float capital )
+{
+	return std::max(0.0f, capital);
+}
+
+void Entity::fill_input( const ChartCursor& cursor, const SimulationTrader& trader, float* in, std::size_t stride )
+{
+	in[0] = cursor.value();
+	in[stride] = trader.active(LongOrder) ? 1.0f : (trader.active(ShortOrder) ? -1.0f : 0.f);
+	in[2 * stride] = trader.active(ShortOrder)? trader.entrance(ShortOrder) : (trader.active(LongOrder)? trader.entrance(LongOrder) : 0.0f);
+}
+
+void Entity::act( SimulationTrader& trader, float price, float do_something, float enter_or_leave )
+{
+	if (do_something >= 0.5f) {
+		if (enter_or_leave >= 0.5f) {
+			// enter
+			if (!trader.is_trading())
+				trader.breach(ENTRY_ORDER, price);
+		}
+		else
+		{
+			// leave
+			if (trader.active(LongOrder))
+				trader.leave(LongOrder, price);
+
+			if (trader.active(ShortOrder))
+				trader.leave(ShortOrder, price);
+		}
+	}
+}
+
+float Entity::fitness() const
+{
+	return mFitness;
+}
+
+void Entity::fitness( float f )
+{
+	mFitness = f;
+}
+
+bool Entity::operator<( const Entity& other )
+{
+	return mFitness < other.mFitness;
+}
+
+const float* Entity::genome() const
+{
+	return mGenome;
+}
+
+/////////////////////////////////////////// Generation ///////////////////////////////////////////
+Generation::Generation( std::size_t pop_count, std::uint64_t seed, GenomeArena& arena, ThreadPool& pool )
+	: mGenerationIndex(0)
+	, mEntities(pop_count)
+{
+	assert(arena.capacity() >= pop_count && arena.genome_size() == AiFormat.weights_count());
+
+	pool.parallel_for(0, pop_count, BREED_CHUNK_SIZE, [&](std::size_t first, std::size_t last) {
+		for(std::size_t idx = first; idx < last; ++idx)
+		{
+			Philox4x32 generator(seed, Philox4x32::stream(0, std::uint32_t(idx)));
+			MyANN::random_weights(AiFormat, generator, arena.genome(idx));
+			mEntities[idx] = Entity(arena.genome(idx));
+		}
+	});
+}
+
+Generation::Generation( std::uint64_t seed, const std::unique_ptr<Generation>& old, GenomeArena& arena, Selection& selection, ThreadPool& pool )
+	: mGenerationIndex(old->mGenerationIndex + 1)
+	, mEntities(old->mEntities.size())
+{
+	const std::vector<Entity>& population = old->mEntities;
+	const std::size_t pop_size = population.size();
+	const std::size_t genome_size = arena.genome_size();
+	assert(arena.capacity() >= pop_size && genome_size == AiFormat.weights_count());
+
+	std::vector<float> fitness(pop_size);
+	for(std::size_t idx = 0; idx < pop_size; ++idx)
+		fitness[idx] = population[idx].fitness();
+
+	// child i uses the slots 2i and 2i + 1 for its parents
+	Philox4x32 selection_generator(seed, Philox4x32::stream(mGenerationIndex, SELECTION_STREAM));
+	selection.prepare(fitness.data(), pop_size, 2 * pop_size, selection_generator);
+
+	// every child has its own random stream, so the result does not depend on the thread count
+	pool.parallel_for(0, pop_size, BREED_CHUNK_SIZE, [&](std::size_t first, std::size_t last) {
+		for(std::size_t child = first; child < last; ++child)
+		{
+			Philox4x32 generator(seed, Philox4x32::stream(mGenerationIndex, std::uint32_t(child)));
+			std::normal_distribution<float> normal_distribution(0.0f, 0.85f);
+			std::uniform_real_distribution<float> zeroone_distribution(0.0f, 1.0f);
+			auto normal_rand = [&]() { return normal_distribution(generator); };
+			auto zeroone_rand = [&]() { return zeroone_distribution(generator); };
+
+			auto& ent = population[selection.select(2 * child, generator)];
+			float* genoms = arena.genome(child);
+			std::copy(ent.genome(), ent.genome() + genome_size, genoms);
+
+			// combine
+			if (zeroone_rand() < 0.1f) {
+
+				auto& ent2 = population[selection.select(2 * child + 1, generator)];
+				auto part = ent2.fitness() / (ent.fitness() + ent2.fitness());
+				const float* genoms2 = ent2.genome();
+				for (std::size_t i = 0; i < genome_size; ++i)
+					genoms[i] = (zeroone_rand() < part) ? genoms2[i] : genoms[i];
+			}
+
+			// mutate
+			if (zeroone_rand() < 0.5) {
+				for (std::size_t i = 0; i < genome_size; ++i)
+					if (zeroone_rand() < 0.2f)
+						genoms[i] += normal_rand();
+			}
+
+			mEntities[child] = Entity(genoms);
+		}
+	});
+}
+
+void Generation::process( ThreadPool& pool, const ChartCorpus& corpus, const EvaluationSettings& settings )
+{
+	const std::size_t pop_size = mEntities.size();
+	const std::size_t scenarios = std::max<std::size_t>(1, std::min(settings.scenario_count, corpus.size()));
+
+	// walk through the corpus, so consecutive generations see different charts
+	std::vector<const ChartModel*> charts(scenarios);
+	for(std::size_t sc = 0; sc < scenarios; ++sc)
+		charts[sc] = &corpus.chart((mGenerationIndex * scenarios + sc) % corpus.size());
+
+	std::uint64_t chart_ticks = 0;
+	for(const ChartModel* chart : charts)
+		chart_ticks += chart->tick_count();
+
+	// fitness of every (entity, chart) pair, row major per entity
+	std::vector<float> results(pop_size * scenarios, 0.0f);
+
+	if(settings.mode == EvaluationSettings::Batched)
+	{
+		const std::size_t batch_count = (pop_size + BATCH_SIZE - 1) / BATCH_SIZE;
+		pool.parallel_for(0, batch_count * scenarios, 1, [&](std::size_t first, std::size_t last) {
+			for(std::size_t item = first; item < last; ++item)
+			{
+				const std::size_t begin = (item / scenarios) * BATCH_SIZE;
+				const std::size_t sc = item % scenarios;
+				_process_batch(begin, std::min<std::size_t>(begin + BATCH_SIZE, pop_size), charts[sc],
+							   results.data() + begin * scenarios + sc, scenarios);
+			}
+		});
+	}else{
+		pool.parallel_for(0, pop_size * scenarios, ENTITY_CHUNK_SIZE, [&](std::size_t first, std::size_t last) {
+			for(std::size_t item = first; item < last; ++item)
+				results[item] = mEntities[item / scenarios].evaluate(charts[item % scenarios]);
+		});
+	}
+
+	if(settings.normalize_fitness)
+	{
+		for(std::size_t idx = 0; idx < results.size(); ++idx)
+			results[idx] = charts[idx % scenarios]->normalized_yield(results[idx]);
+	}
+
+	for(std::size_t idx = 0; idx < pop_size; ++idx)
+		mEntities[idx].fitness(_aggregate(results.data() + idx * scenarios, scenarios, settings));
+
+	float avg_fitness = std::accumulate(mEntities.begin(), mEntities.end(), 0.0f, [](float acc, const Entity& e){return e.fitness() + acc;}) / float(pop_size);
+
+	std::sort(mEntities.begin(), mEntities.end());
+	mStats.min_fitness = mEntities.front().fitness();
+	mStats.avg_fitness = avg_fitness;
+	mStats.max_fitness = mEntities.back().fitness();
+	mStats.generation = mGenerationIndex;
+	mStats.simulated_ticks = chart_ticks * pop_size;
+}
+
+PopulationStats Generation::stats() const
+{
+	return mStats;
+}
+
+std::size_t Generation::index() const
+{
+	return mGenerationIndex;
+}
+
+// simulates the entities [first, last) in lock step, so each tick needs only one batched network evaluation.
+// The fitness of entity first + i is written to results[i * stride].
+void Generation::_process_batch( std::size_t first, std::size_t last, const ChartModel* model, float* results, std::size_t stride ) const
+{
+	const std::size_t count = last - first;
+	TickChart chart(model);
+	MyANNBatch batch(AiFormat, count);
+	TraderBatch<EntityCharge> traders(count, 0.0f);
+
+	for(std::size_t idx = 0; idx < count; ++idx)
+		batch.load(idx, mEntities[first + idx].genome());
+
+	const ChartCursor& cursor = chart.cursor();
+	while(!cursor.is_done())
+	{
+		// the inputs of Entity::fill_input, one row per input neuron
+		const float price = cursor.value();
+		std::fill(batch.in(0), batch.in(0) + count, price);
+		std::copy(traders.position(), traders.position() + count, batch.in(1));
+		std::copy(traders.entrance(), traders.entrance() + count, batch.in(2));
+
+		batch.process();
+
+		traders.act(price, batch.out(0), batch.out(1), Entity::ENTRY_ORDER);
+		chart.walk_tick();
+	}
+
+	const float* capital = traders.capital();
+	for(std::size_t idx = 0; idx < count; ++idx)
+		results[idx * stride] = Entity::score(capital[idx]);
+}
+
+float Generation::_aggregate( float* values, std::size_t count, const EvaluationSettings& settings )
+{
+	switch(settings.aggregation)
+	{
+	case EvaluationSettings::Min:
+		return *std::min_element(values, values + count);
+	case EvaluationSettings::Quantile:
+		{
+			const std::size_t nth = std::size_t(between(0.0f, settings.quantile, 1.0f) * float(count - 1));
+			std::nth_element(values, values + nth, values + count);
+			return values[nth];
+		}
+	default:
+		return std::accumulate(values, values + count, 0.0f) / float(count);
+	}
+}
+
+/////////////////////////////////////////// AiTest ///////////////////////////////////////////
+AiTest::AiTest( const TrainingSettings& settings, AiTestObserver* observer )
+	: mRunning(false)
+	, mSettings(settings)
+	, mObserver(observer)
+	, mSeed(settings.seed? settings.seed : (unsigned)std::chrono::system_clock::now().time_since_epoch().count())
+	, mPool(settings.thread_count)
+	, mSelection(CreateSelection(settings.selection))
+{
+	for(auto& arena : mArenas)
+		arena.reset(new GenomeArena(AiFormat.weights_count(), settings.population_size));
+}
+
+AiTest::~AiTest()
+{
+	stop();
+}
+
+void AiTest::run()
+{
+	mRunning = true;
+	_train();
+}
+
+void AiTest::start()
+{
+	// set before the thread starts, so an early stop() is not lost
+	mRunning = true;
+	mThread = std::thread(std::bind(&AiTest::_train, this));
+}
+
+void AiTest::stop()
+{
+	mRunning = false;
+	if(mThread.joinable())
+		mThread.join();
+}
+
+const TrainingSettings& AiTest::settings() const
+{
+	return mSettings;
+}
+
+unsigned int AiTest::seed() const
+{
+	return mSeed;
+}
+
+void AiTest::_train()
+{
+	if(!mCorpus)
+	{
+		if(mSettings.corpus_path.empty())
+			mCorpus.reset(new ChartCorpus(MIN_CHART_VALUE, MAX_CHART_VALUE, CHART_VOLATILITY, std::size_t(CHART_IN_SECONDS * TICKS_PER_SECOND), mSettings.corpus_size, mSeed, &mPool));
+		else
+			mCorpus.reset(new ChartCorpus(mSettings.corpus_path));
+	}
+
+	while (mRunning)
+	{
+		if(!mCurrentGeneration)
+		{
+			mCurrentGeneration.reset(new Generation(mSettings.population_size, mSeed, *mArenas[0], mPool));
+		}else{
+			GenomeArena& arena = *mArenas[(mCurrentGeneration->index() + 1) % 2];
+			mCurrentGeneration.reset(new Generation(mSeed, mCurrentGeneration, arena, *mSelection, mPool));
+		}
+
+		mCurrentGeneration->process(mPool, *mCorpus, mSettings.evaluation);
+
+		const PopulationStats stats = mCurrentGeneration->stats();
+		if(mObserver)
+			mObserver->generation_done(stats);
+
+		if(mSettings.generation_limit && stats.generation + 1 >= mSettings.generation_limit)
+			mRunning = false;
+	}
+}
@@ -0,0 +1,203 @@
+#pragma once
+#ifndef _AI_TEST_HPP
+#define _AI_TEST_HPP
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include "ann.hpp"
+#include "ann_batch.hpp"
+#include "ann_static.hpp"
+#include "chart_corpus.hpp"
+#include "basic_trader.hpp"
+#include "realtime_chart.hpp"
+#include "thread_pool.hpp"
+#include "selection.hpp"
+#include "philox.hpp"
+#include "genome_arena.hpp"
+
+
+typedef ANN<3, 2> MyANN;
+typedef ANNBatch<3, 2> MyANNBatch;
+typedef ANNStatic<3, 5, 3, 2> MyStaticANN;
+
+extern const ANNFormat<3, 2> AiFormat;
+
+
+struct PopulationStats
+{
+	float max_fitness;
+	float avg_fitness;
+	float min_fitness;
+	std::size_t generation;
+	// ticks simulated by all entities of the generation together
+	std::uint64_t simulated_ticks;
+};
+
+struct EvaluationSettings
+{
+	enum Mode
+	{
+		PerEntity,
+		Batched
+	};
+
+	// how the fitness on the single charts is combined into the fitness of an entity
+	enum Aggregation
+	{
+		Mean,
+		Min,
+		Quantile
+	};
+
+	EvaluationSettings();
+
+	Mode mode;
+	std::size_t scenario_count;
+	Aggregation aggregation;
+	float quantile;
+	// score every chart relative to its best possible trade, so easy and hard charts weigh the same
+	bool normalize_fitness;
+};
+
+struct TrainingSettings
+{
+	TrainingSettings();
+
+	std::size_t population_size;
+	// 0 trains until stop() is called
+	std::size_t generation_limit;
+	// 0 uses one thread per hardware thread
+	std::size_t thread_count;
+	// 0 seeds from the clock
+	unsigned int seed;
+	// the corpus is loaded from this chart file, or generated if it is empty
+	std::string corpus_path;
+	std::size_t corpus_size;
+	EvaluationSettings evaluation;
+	SelectionSettings selection;
+};
+
+
+// fee the entities pay for every breach and leave
+struct EntityCharge
+{
+	float operator ()(float) const
+	{
+		return 0.5f;
+	}
+};
+
+typedef BasicTrader<EntityCharge> SimulationTrader;
+
+
+// An entity only references its genome, the weights live in the GenomeArena of its generation.
+class Entity
+{
+public:
+	// the network has no output for the order type yet, so entities always enter with this one
+	static const OrderType ENTRY_ORDER = LongOrder;
+
+public:
+	Entity(const float* genome = nullptr);
+
+	float evaluate(const ChartModel* model) const;
+
+	static float score(float capital);
+
+	// writes the network input for the trader into in[0], in[stride], in[2 * stride]
+	static void fill_input(const ChartCursor& cursor, const SimulationTrader& trader, float* in, std::size_t stride);
+	static void act(SimulationTrader& trader, float price, float do_something, float enter_or_leave);
+
+	float fitness() const;
+	void fitness(float f);
+
+	bool operator <(const Entity& other);
+
+	// AiFormat.weights_count() weights
+	const float* genome() const;
+
+private:
+	const float* mGenome;
+	float mFitness;
+};
+
+
+// One population. The genomes are written into the given arena, which has to outlive the generation
+// and must not be the arena of the parent generation.
+class Generation
+{
+public:
+	// random networks, the streams of generation 0 of the seed are used
+	Generation(std::size_t pop_count, std::uint64_t seed, GenomeArena& arena, ThreadPool& pool);
+	// breeds the next generation in parallel, reproducible for the same seed and old generation
+	Generation(std::uint64_t seed, const std::unique_ptr<Generation>& old, GenomeArena& arena, Selection& selection, ThreadPool& pool);
+
+	// evaluates every entity on settings.scenario_count charts of the corpus
+	void process(ThreadPool& pool, const ChartCorpus& corpus, const EvaluationSettings& settings);
+
+	PopulationStats stats() const;
+	std::size_t index() const;
+
+private:
+	void _process_batch(std::size_t first, std::size_t last, const ChartModel* model, float* results, std::size_t stride) const;
+	static float _aggregate(float* values, std::size_t count, const EvaluationSettings& settings);
+
+private:
+	int mGenerationIndex;
+	std::vector<Entity> mEntities;
+	PopulationStats mStats;
+};
+
+
+// Gets the stats of every finished generation, called from the training thread.
+class AiTestObserver
+{
+public:
+	virtual ~AiTestObserver() {}
+	virtual void generation_done(const PopulationStats& stats) = 0;
+};
+
+
+// The training engine, independent of any ui.
+// run() trains in the calling thread, start() in a background thread.
+class AiTest
+{
+public:
+	AiTest(const TrainingSettings& settings = TrainingSettings(), AiTestObserver* observer = nullptr);
+	~AiTest();
+
+	void run();
+	void start();
+	void stop();
+
+	const TrainingSettings& settings() const;
+	// the seed actually used, also if the settings asked for a clock seed
+	unsigned int seed() const;
+
+private:
+	AiTest(const AiTest&);
+	AiTest& operator =(const AiTest&);
+
+	void _train();
+
+private:
+	// read by the training thread, written by stop() from any thread
+	std::atomic<bool> mRunning;
+	const TrainingSettings mSettings;
+	AiTestObserver* mObserver;
+	const unsigned int mSeed;
+	ThreadPool mPool;
+	std::unique_ptr<Selection> mSelection;
+	// the generations alternate between the two arenas
+	std::unique_ptr<GenomeArena> mArenas[2];
+	std::unique_ptr<ChartCorpus> mCorpus;
+	std::unique_ptr<Generation> mCurrentGeneration;
+	std::thread mThread;
+};
+
+
+#endif
@@ -4,7 +4,12 @@
 
 #include <memory>
 #include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cassert>
 #include "array.hpp"
+#include "ann_kernel.hpp"
 
 
 template<std::size_t InputNeurons, std::size_t OutputNeurons>
@@ -69,7 +74,7 @@ private:
 template<std::size_t InputNeurons, std::size_t OutputNeurons, typename ValueType = float>
 class ANNData
 {
-	template<std::size_t InputNeurons, std::size_t OutputNeurons, typename ValueType>
+	template<std::size_t InN, std::size_t OutN, typename ValueT>
 	friend class ANN;
 public:
 	typedef ANNFormat<InputNeurons, OutputNeurons> format_type;
@@ -127,10 +132,20 @@ public:
 		assert(mWeightList.size() == format.weights_count());
 	}
 
+	// writes format.weights_count() random initial weights
+	template<typename Generator>
+	static void random_weights(const format_type& format, Generator& generator, weight_type* weights)
+	{
+		std::uniform_real_distribution<weight_type> neuronal_distribution(-1.0f, 1.0f);
+		const std::size_t wcount = format.weights_count();
+		for(std::size_t idx = 0; idx < wcount; ++idx)
+			weights[idx] = neuronal_distribution(generator);
+	}
+
 	ANN(ANN&& other)
 		: mFormat(other.mFormat)
 		, mWeightList(std::move(other.mWeightList))
-		, mActivationResponse(other.act_response)
+		, mActivationResponse(other.mActivationResponse)
 	{
 	}
 
@@ -172,7 +187,7 @@ public:
 		assert(format().layer_count() <= 1 || std::distance(hdd2_begin, hdd2_end) == format().hidden_neurons());
 
 		const auto output_neurons = format().output_neurons();
-		auto weight_it = mWeightList.begin();
+		const weight_type* weight_it = mWeightList.data();
 
 		if(format().layer_count() > 0)
 		{
@@ -210,6 +225,16 @@ public:
 	}
 
 private:
+	// contiguous layers, as used by process(data_type&), go to the simd kernels
+	void _process_layer(value_type* in_begin, value_type* in_end,
+						value_type* out, value_type* out_end,
+						const weight_type*& weight_it) const
+	{
+		weight_it = ProcessLayer(in_begin, std::size_t(in_end - in_begin),
+								 out, std::size_t(out_end - out),
+								 weight_it, mActivationResponse);
+	}
+
 	template<typename InIter, typename OutIter, typename WeightIter>
 	void _process_layer(InIter in_begin, InIter in_end,
 						OutIter out, OutIter out_end,
@@ -236,17 +261,9 @@ private:
 
 	void _create_random_weight_list(unsigned int seed)
 	{
-		typedef std::uniform_real_distribution<float> distribution_type;
 		std::default_random_engine generator(seed);
-
-		distribution_type neuronal_distribution(-1.0f, 1.0f);
-		auto neuro_rand = [&]() { return neuronal_distribution(generator); };
-
-		auto wcount = format().weights_count();
-
-		mWeightList = weight_list::New(wcount);
-		for(auto& w : mWeightList)
-			w = neuro_rand();
+		mWeightList = weight_list::New(format().weights_count());
+		random_weights(format(), generator, mWeightList.data());
 	}
 
 private:
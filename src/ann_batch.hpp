@@ -0,0 +1,136 @@
+#pragma once
+#ifndef _ANN_BATCH_HPP
+#define _ANN_BATCH_HPP
+
+#include <algorithm>
+#include "ann.hpp"
+
+
+// Evaluates many networks of the same format with one call.
+// All values are stored as structure of arrays: value k of every network is
+// followed by value k of the next network, so the innermost loop of a layer
+// walks over the networks through contiguous memory and can be vectorized.
+template<std::size_t InputNeurons, std::size_t OutputNeurons, typename ValueType = float>
+class ANNBatch
+{
+public:
+	typedef ANNFormat<InputNeurons, OutputNeurons> format_type;
+	typedef ValueType value_type;
+	typedef value_type weight_type;
+	typedef Array<value_type> value_list;
+	typedef Array<weight_type> weight_list;
+	typedef ANN<InputNeurons, OutputNeurons, ValueType> ann_type;
+
+public:
+	ANNBatch(const format_type& format, std::size_t network_count, value_type act_response = 1)
+		: mFormat(format)
+		, mNetworkCount(network_count)
+		, mActivationResponse(act_response)
+		, mWeights(weight_list::New(format.weights_count() * network_count))
+		, mIn(value_list::New(format.input_neurons() * network_count))
+		, mOut(value_list::New(format.output_neurons() * network_count))
+		, mHiddenFst(value_list::New(format.layer_count() > 0? format.hidden_neurons() * network_count : 0))
+		, mHiddenSnd(value_list::New(format.layer_count() > 1? format.hidden_neurons() * network_count : 0))
+	{
+	}
+
+	~ANNBatch()
+	{
+	}
+
+	const format_type& format() const { return mFormat; }
+	std::size_t network_count() const { return mNetworkCount; }
+	value_type activation_resonse() const { return mActivationResponse; }
+
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void load(std::size_t network, const weight_type* weights)
+	{
+		assert(network < network_count());
+		const auto wcount = format().weights_count();
+		for(std::size_t w = 0; w < wcount; ++w)
+			mWeights[w * mNetworkCount + network] = weights[w];
+	}
+
+	void load(std::size_t network, const ann_type& ann)
+	{
+		assert(format() == ann.format());
+		assert(ann.activation_resonse() == activation_resonse());
+		load(network, ann.neuron_weights().data());
+	}
+
+	// one value per network
+	value_type* in(std::size_t neuron)
+	{
+		assert(neuron < format().input_neurons());
+		return mIn.data() + neuron * mNetworkCount;
+	}
+
+	const value_type* out(std::size_t neuron) const
+	{
+		assert(neuron < format().output_neurons());
+		return mOut.data() + neuron * mNetworkCount;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void process()
+	{
+		const weight_type* weight_it = mWeights.data();
+
+		if(format().layer_count() > 0)
+		{
+			const auto hidden_neurons = format().hidden_neurons();
+			value_type* from = mHiddenFst.data();
+			value_type* to = mHiddenSnd.data();
+
+			_process_layer(mIn.data(), format().input_neurons(), from, hidden_neurons, weight_it);
+
+			for(std::size_t idx = 1; idx < format().layer_count(); ++idx)
+			{
+				_process_layer(from, hidden_neurons, to, hidden_neurons, weight_it);
+				std::swap(from, to);
+			}
+
+			_process_layer(from, hidden_neurons, mOut.data(), format().output_neurons(), weight_it);
+		}else{
+			_process_layer(mIn.data(), format().input_neurons(), mOut.data(), format().output_neurons(), weight_it);
+		}
+
+		assert(weight_it == mWeights.data() + mWeights.size());
+	}
+
+private:
+	void _process_layer(const value_type* in, std::size_t in_count,
+						value_type* out, std::size_t out_count,
+						const weight_type*& weight_it) const
+	{
+		const std::size_t n = mNetworkCount;
+
+		for(std::size_t o = 0; o < out_count; ++o)
+		{
+			value_type* acc = out + o * n;
+			std::fill(acc, acc + n, value_type(0));
+
+			for(std::size_t i = 0; i < in_count; ++i)
+			{
+				const value_type* x = in + i * n;
+				for(std::size_t k = 0; k < n; ++k)
+					acc[k] += weight_it[k] * x[k];
+				weight_it += n;
+			}
+
+			SigmoidArray(acc, n, mActivationResponse);
+		}
+	}
+
+private:
+	format_type mFormat;
+	std::size_t mNetworkCount;
+	value_type mActivationResponse;
+	weight_list mWeights;
+	value_list mIn;
+	value_list mOut;
+	value_list mHiddenFst;
+	value_list mHiddenSnd;
+};
+
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+#ifndef _ANN_KERNEL_HPP
+#define _ANN_KERNEL_HPP
+
+#include <cstddef>
+#include <cmath>
+
+
+enum SimdLevel
+{
+	Simd_Scalar,
+	Simd_SSE2,
+	Simd_AVX2,
+	Simd_AVX512
+};
+
+// best instruction set supported by cpu and os
+SimdLevel DetectSimdLevel();
+
+// widest instruction set used by ProcessLayer
+SimdLevel CurrentSimdLevel();
+
+// selects the kernel for ProcessLayer, levels above DetectSimdLevel() are clamped
+SimdLevel SelectSimdLevel(SimdLevel level);
+
+const char* SimdLevelName(SimdLevel level);
+
+
+// Computes one fully connected layer: out[o] = sigmoid(dot(weights[o * in_count...], in)).
+// The weights are row major, one row per output neuron. Returns the weight pointer behind the layer.
+// Every layer gets the widest kernel up to CurrentSimdLevel() that pays off for its size,
+// small layers run the scalar loop.
+const float* ProcessLayer(const float* in, std::size_t in_count,
+						  float* out, std::size_t out_count,
+						  const float* weights, float act_response);
+
+template<typename T>
+const T* ProcessLayer(const T* in, std::size_t in_count,
+					  T* out, std::size_t out_count,
+					  const T* weights, T act_response)
+{
+	for(std::size_t o = 0; o < out_count; ++o)
+	{
+		T out_value(0);
+		for(std::size_t i = 0; i < in_count; ++i)
+			out_value += weights[i] * in[i];
+		weights += in_count;
+
+		out[o] = (T(1) / (T(1) + std::exp(-out_value / act_response)));
+	}
+	return weights;
+}
+
+
+// values[k] = sigmoid(values[k]) for count values, with the exp approximation of the kernels
+void SigmoidArray(float* values, std::size_t count, float act_response);
+
+template<typename T>
+void SigmoidArray(T* values, std::size_t count, T act_response)
+{
+	for(std::size_t k = 0; k < count; ++k)
+		values[k] = (T(1) / (T(1) + std::exp(-values[k] / act_response)));
+}
+
+
+#endif
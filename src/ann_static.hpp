@@ -0,0 +1,160 @@
+#pragma once
+#ifndef _ANN_STATIC_HPP
+#define _ANN_STATIC_HPP
+
+#include <array>
+#include <algorithm>
+#include "ann.hpp"
+
+
+// dot product of N weights and values, unrolled at compile time.
+// ANN sums in a different order in its SIMD kernels and uses an approximated exp,
+// so both agree only to within rounding.
+template<std::size_t N, typename T>
+struct ANNStaticDot
+{
+	static T run(const T* w, const T* x)
+	{
+		return ANNStaticDot<N - 1, T>::run(w, x) + w[N - 1] * x[N - 1];
+	}
+};
+
+template<typename T>
+struct ANNStaticDot<0, T>
+{
+	static T run(const T*, const T*)
+	{
+		return T(0);
+	}
+};
+
+// computes the neurons [0, Out) of a fully connected layer
+template<std::size_t In, std::size_t Out, typename T>
+struct ANNStaticLayer
+{
+	static void run(const T* w, const T* in, T* out, T neg_inv_response)
+	{
+		ANNStaticLayer<In, Out - 1, T>::run(w, in, out, neg_inv_response);
+		out[Out - 1] = T(1) / (T(1) + std::exp(ANNStaticDot<In, T>::run(w + (Out - 1) * In, in) * neg_inv_response));
+	}
+};
+
+template<std::size_t In, typename T>
+struct ANNStaticLayer<In, 0, T>
+{
+	static void run(const T*, const T*, T*, T)
+	{
+	}
+};
+
+// runs the remaining Layers hidden to hidden layers
+template<std::size_t Hidden, std::size_t Layers, typename T>
+struct ANNStaticHidden
+{
+	static const T* run(const T* w, std::array<T, Hidden>& values, T neg_inv_response)
+	{
+		std::array<T, Hidden> next;
+		ANNStaticLayer<Hidden, Hidden, T>::run(w, values.data(), next.data(), neg_inv_response);
+		values = next;
+		return ANNStaticHidden<Hidden, Layers - 1, T>::run(w + Hidden * Hidden, values, neg_inv_response);
+	}
+};
+
+template<std::size_t Hidden, typename T>
+struct ANNStaticHidden<Hidden, 0, T>
+{
+	static const T* run(const T* w, std::array<T, Hidden>&, T)
+	{
+		return w;
+	}
+};
+
+template<std::size_t In, std::size_t Hidden, std::size_t Layers, std::size_t Out, typename T>
+struct ANNStaticForward
+{
+	static void run(const T* w, const T* in, T* out, T neg_inv_response)
+	{
+		std::array<T, Hidden> hidden;
+		ANNStaticLayer<In, Hidden, T>::run(w, in, hidden.data(), neg_inv_response);
+		w = ANNStaticHidden<Hidden, Layers - 1, T>::run(w + In * Hidden, hidden, neg_inv_response);
+		ANNStaticLayer<Hidden, Out, T>::run(w, hidden.data(), out, neg_inv_response);
+	}
+};
+
+template<std::size_t In, std::size_t Hidden, std::size_t Out, typename T>
+struct ANNStaticForward<In, Hidden, 0, Out, T>
+{
+	static void run(const T* w, const T* in, T* out, T neg_inv_response)
+	{
+		ANNStaticLayer<In, Out, T>::run(w, in, out, neg_inv_response);
+	}
+};
+
+
+// ANN with the whole topology fixed at compile time.
+// The forward pass is completely unrolled and keeps the hidden values on the stack.
+// The weights use the same layout as ANN, so genomes can be moved between both.
+template<std::size_t InputNeurons, std::size_t HiddenNeurons, std::size_t LayerCount, std::size_t OutputNeurons, typename ValueType = float>
+class ANNStatic
+{
+public:
+	static const std::size_t input_neuron_count = InputNeurons;
+	static const std::size_t hidden_neuron_count = HiddenNeurons;
+	static const std::size_t layer_count = LayerCount;
+	static const std::size_t output_neuron_count = OutputNeurons;
+	static const std::size_t weights_count = LayerCount > 0
+			? InputNeurons * HiddenNeurons + HiddenNeurons * HiddenNeurons * (LayerCount - 1) + HiddenNeurons * OutputNeurons
+			: InputNeurons * OutputNeurons;
+
+	typedef ANNFormat<InputNeurons, OutputNeurons> format_type;
+	typedef ANN<InputNeurons, OutputNeurons, ValueType> ann_type;
+	typedef ValueType value_type;
+	typedef value_type weight_type;
+	typedef Array<weight_type> weight_list;
+	typedef std::array<value_type, InputNeurons> input_type;
+	typedef std::array<value_type, OutputNeurons> output_type;
+
+public:
+	ANNStatic(const weight_type* weights, value_type act_response = 1)
+		: mActivationResponse(act_response)
+	{
+		std::copy(weights, weights + weights_count, mWeights.begin());
+	}
+
+	explicit ANNStatic(const ann_type& ann)
+		: mActivationResponse(ann.activation_resonse())
+	{
+		assert(ann.format() == format());
+		std::copy(ann.neuron_weights().cbegin(), ann.neuron_weights().cend(), mWeights.begin());
+	}
+
+	static format_type format()
+	{
+		return format_type(HiddenNeurons, LayerCount);
+	}
+
+	const std::array<weight_type, weights_count>& neuron_weights() const { return mWeights; }
+
+	value_type activation_resonse() const { return mActivationResponse; }
+
+	ann_type to_ann() const
+	{
+		weight_list weights = weight_list::New(weights_count);
+		std::copy(mWeights.begin(), mWeights.end(), weights.begin());
+		return ann_type(format(), std::move(weights), mActivationResponse);
+	}
+
+	output_type process(const input_type& in) const
+	{
+		output_type out;
+		ANNStaticForward<InputNeurons, HiddenNeurons, LayerCount, OutputNeurons, value_type>::run(
+				mWeights.data(), in.data(), out.data(), value_type(-1) / mActivationResponse);
+		return out;
+	}
+
+private:
+	std::array<weight_type, weights_count> mWeights;
+	value_type mActivationResponse;
+};
+
+#endif
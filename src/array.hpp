@@ -3,13 +3,21 @@
 #define _ARRAY_HPP
 
 #include <memory>
-
-template<typename T>
+#include <new>
+#include <cassert>
+#include <algorithm>
+#include <type_traits>
+#include "memory_pool.hpp"
+
+// Allocator is a policy with static allocate(bytes)/deallocate(ptr, bytes),
+// see memory_pool.hpp. The storage is aligned to MEMORY_ALIGNMENT.
+template<typename T, typename Allocator = PoolAllocator>
 class Array
 {
 public:
 	typedef std::size_t size_type;
-	typedef Array<T> self_type;
+	typedef Allocator allocator_type;
+	typedef Array<T, Allocator> self_type;
 	typedef T value_type;
 	typedef T& reference_type;
 	typedef T* pointer_type;
@@ -18,33 +26,40 @@ public:
 public:
 	Array()
 		: mSize(0)
+		, mValues(nullptr)
 	{
 	}
 
 	Array(Array&& _old)
 		: mSize(_old.mSize)
+		, mValues(_old.mValues)
 	{
-		mValues = std::move(_old.mValues);
+		_old.mValues = nullptr;
 		_old.mSize = 0;
 	}
 
 	~Array()
 	{
+		_release();
 	}
 
 	self_type& operator =(Array&& _old)
 	{
-		mValues = std::move(_old.mValues);
-		mSize = _old.mSize;
-		_old.mSize = 0;
+		if(this != &_old)
+		{
+			_release();
+			mValues = _old.mValues;
+			mSize = _old.mSize;
+			_old.mValues = nullptr;
+			_old.mSize = 0;
+		}
 
 		return (*this);
 	}
 
 	self_type& operator =(std::nullptr_t)
 	{
-		mSize = 0;
-		mValues.reset();
+		_release();
 
 		return (*this);
 	}
@@ -74,12 +89,12 @@ public:
 
 	pointer_type data()
 	{
-		return mValues.get();
+		return mValues;
 	}
 
 	const pointer_type data() const
 	{
-		return mValues.get();
+		return mValues;
 	}
 
 	value_type& front()
@@ -104,7 +119,7 @@ public:
 
 	iterator begin()
 	{
-		return mValues.get();
+		return mValues;
 	}
 
 	iterator end()
@@ -114,7 +129,7 @@ public:
 
 	const_iterator begin() const
 	{
-		return mValues.get();
+		return mValues;
 	}
 
 	const_iterator end() const
@@ -124,7 +139,7 @@ public:
 
 	const_iterator cbegin() const
 	{
-		return mValues.get();
+		return mValues;
 	}
 
 	const_iterator cend() const
@@ -141,7 +156,10 @@ public:
 	{
 		if(_size > 0)
 		{
-			return Array(new value_type[_size], _size);
+			value_type* values = static_cast<value_type*>(allocator_type::allocate(_size * sizeof(value_type)));
+			for(size_type idx = 0; idx < _size; ++idx)
+				new (values + idx) value_type;
+			return Array(values, _size);
 		}else{
 			return Array();
 		}
@@ -163,9 +181,25 @@ private:
 
 	Array(const Array&);
 	Array& operator =(const Array&);
+
+	void _release()
+	{
+		if(mValues)
+		{
+			if(!std::is_trivially_destructible<value_type>::value)
+			{
+				for(size_type idx = mSize; idx > 0; --idx)
+					mValues[idx - 1].~value_type();
+			}
+			allocator_type::deallocate(mValues, mSize * sizeof(value_type));
+		}
+		mValues = nullptr;
+		mSize = 0;
+	}
+
 private:
 	size_type mSize;
-	std::unique_ptr<value_type[]> mValues;
+	value_type* mValues;
 };
 
 #endif
@@ -0,0 +1,113 @@
+#pragma once
+#ifndef _BASIC_TRADER_HPP
+#define _BASIC_TRADER_HPP
+
+#include <cassert>
+
+
+enum OrderType
+{
+	ShortOrder,
+	LongOrder
+};
+
+
+// charge policies, called with the price of a trade and returning its fee
+struct NoCharge
+{
+	float operator ()(float) const
+	{
+		return 0.0f;
+	}
+};
+
+struct FlatCharge
+{
+	explicit FlatCharge(float fee)
+		: fee(fee)
+	{
+	}
+
+	float operator ()(float) const
+	{
+		return fee;
+	}
+
+	float fee;
+};
+
+
+// Trader with one short and one long order, for simulations.
+// The charge policy is a type parameter and the price is passed to every trade, so nothing
+// is virtual or allocated and the trades compile to straight-line code. A trader is a plain
+// value and can be stored by the thousands in a vector.
+template<typename Charge>
+class BasicTrader
+{
+public:
+	explicit BasicTrader(float capital, const Charge& charge = Charge())
+		: mCharge(charge)
+		, mCapital(capital)
+	{
+		mActive[ShortOrder] = mActive[LongOrder] = false;
+		mEntrance[ShortOrder] = mEntrance[LongOrder] = 0.0f;
+	}
+
+	float capital() const
+	{
+		return mCapital;
+	}
+
+	bool active(OrderType type) const
+	{
+		return mActive[type];
+	}
+
+	bool is_trading() const
+	{
+		return mActive[ShortOrder] || mActive[LongOrder];
+	}
+
+	float entrance(OrderType type) const
+	{
+		assert(mActive[type]);
+		return mEntrance[type];
+	}
+
+	void breach(OrderType type, float price)
+	{
+		assert(!mActive[type]);
+		assert(price >= 0.0f);
+
+		mEntrance[type] = price;
+		mCapital -= mCharge(price);
+		mActive[type] = true;
+	}
+
+	// returns the change of the capital
+	float leave(OrderType type, float price)
+	{
+		assert(mActive[type]);
+
+		const float old_capital = mCapital;
+		const float diff = price - mEntrance[type];
+
+		mCapital -= mCharge(price);
+		if(type == LongOrder)
+			mCapital += diff;
+		else
+			mCapital -= diff;
+
+		mActive[type] = false;
+		return mCapital - old_capital;
+	}
+
+private:
+	Charge mCharge;
+	float mCapital;
+	bool mActive[2];
+	float mEntrance[2];
+};
+
+
+#endif
@@ -0,0 +1,77 @@
+#include <cassert>
+#include <algorithm>
+#include "chart_corpus.hpp"
+#include "chart_generator.hpp"
+#include "thread_pool.hpp"
+
+
+
+#define GENERATE_GRAIN 4
+
+
+ChartCorpus::ChartCorpus(float min_value, float max_value, float volatility, std::size_t tick_count,
+						 std::size_t chart_count, std::uint64_t seed, ThreadPool* pool)
+	: mGeneratedCharts(chart_count)
+{
+	// every chart starts on its own cache line
+	const std::size_t per_line = MEMORY_ALIGNMENT / sizeof(float);
+	const std::size_t stride = (tick_count + per_line - 1) / per_line * per_line;
+	mGeneratedValues = Array<float>::New(stride * chart_count);
+
+	// works on groups of GENERATOR_LANES charts, so only the last group has idle lanes
+	auto generate = [&](std::size_t first_group, std::size_t last_group) {
+		const std::size_t first = first_group * GENERATOR_LANES;
+		const std::size_t last = std::min(last_group * GENERATOR_LANES, chart_count);
+		float* values = mGeneratedValues.data() + first * stride;
+		GenerateWalks(values, stride, tick_count, first, last - first, min_value, max_value, volatility, seed);
+
+		for(std::size_t idx = first; idx < last; ++idx)
+		{
+			const float* chart_values = mGeneratedValues.data() + idx * stride;
+			mGeneratedCharts[idx].reset(new ChartModel(chart_values, tick_count, min_value, max_value, 0.0f));
+		}
+	};
+
+	const std::size_t group_count = (chart_count + GENERATOR_LANES - 1) / GENERATOR_LANES;
+	if(pool)
+		pool->parallel_for(0, group_count, GENERATE_GRAIN, generate);
+	else
+		generate(0, group_count);
+
+	for(auto& chart : mGeneratedCharts)
+		mCharts.push_back(chart.get());
+}
+
+ChartCorpus::ChartCorpus( const std::string& path )
+	: mFile(new ChartFile(path))
+{
+	for(std::size_t idx = 0; idx < mFile->size(); ++idx)
+	{
+		mCharts.push_back(&mFile->chart(idx));
+	}
+}
+
+ChartCorpus::~ChartCorpus()
+{
+}
+
+std::size_t ChartCorpus::size() const
+{
+	return mCharts.size();
+}
+
+const ChartModel& ChartCorpus::chart( std::size_t idx ) const
+{
+	assert(idx < mCharts.size());
+	return *mCharts[idx];
+}
+
+void ChartCorpus::save( const std::string& path ) const
+{
+	ChartFileWriter writer(path, mCharts.size());
+	for(const ChartModel* chart : mCharts)
+	{
+		writer.write_chart(*chart);
+	}
+	writer.close();
+}
@@ -0,0 +1,43 @@
+#pragma once
+#ifndef _CHART_CORPUS_HPP
+#define _CHART_CORPUS_HPP
+
+#include <vector>
+#include <memory>
+#include <string>
+#include "chart_model.hpp"
+#include "chart_file.hpp"
+#include "array.hpp"
+
+class ThreadPool;
+
+
+// A fixed set of charts, generated once or mapped from a chart file and afterwards
+// only read, so it can be shared between all worker threads without locking.
+class ChartCorpus
+{
+public:
+	// chart i is GenerateWalks chart i of the seed; the charts are generated in parallel if a pool is given
+	ChartCorpus(float min_value, float max_value, float volatility, std::size_t tick_count,
+				std::size_t chart_count, std::uint64_t seed, ThreadPool* pool = nullptr);
+	explicit ChartCorpus(const std::string& path);
+	~ChartCorpus();
+
+	std::size_t size() const;
+	const ChartModel& chart(std::size_t idx) const;
+
+	void save(const std::string& path) const;
+
+private:
+	ChartCorpus(const ChartCorpus&);
+	ChartCorpus& operator =(const ChartCorpus&);
+
+private:
+	std::vector<const ChartModel*> mCharts;
+	Array<float> mGeneratedValues;
+	std::vector<std::unique_ptr<const ChartModel>> mGeneratedCharts;
+	std::unique_ptr<const ChartFile> mFile;
+};
+
+
+#endif
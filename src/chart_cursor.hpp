@@ -0,0 +1,64 @@
+#pragma once
+#ifndef _CHART_CURSOR_HPP
+#define _CHART_CURSOR_HPP
+
+#include <cassert>
+#include <cstddef>
+#include "chart_model.hpp"
+
+
+// Position in the values of a chart, for simulations that walk a chart tick by tick.
+// Unlike WalkingChart nothing is virtual and the range is only checked in debug builds,
+// so reading the current value is a single load.
+class ChartCursor
+{
+public:
+	ChartCursor(const float* values, std::size_t tick_count)
+		: mValues(values)
+		, mTickCount(tick_count)
+		, mTick(0)
+	{
+		assert(mValues || mTickCount == 0);
+	}
+
+	explicit ChartCursor(const ChartModel& model)
+		: mValues(model.values())
+		, mTickCount(model.tick_count())
+		, mTick(0)
+	{
+	}
+
+	float value() const
+	{
+		assert(mTick < mTickCount);
+		return mValues[mTick];
+	}
+
+	std::size_t tick() const
+	{
+		return mTick;
+	}
+
+	std::size_t tick_count() const
+	{
+		return mTickCount;
+	}
+
+	bool is_done() const
+	{
+		return mTick >= mTickCount;
+	}
+
+	void advance(std::size_t count = 1)
+	{
+		mTick += count;
+	}
+
+private:
+	const float* mValues;
+	std::size_t mTickCount;
+	std::size_t mTick;
+};
+
+
+#endif
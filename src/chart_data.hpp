@@ -4,6 +4,28 @@
 
 #include <cstddef>
 
+
+// A run of data points in contiguous memory, point i is at (x[i], y[i]),
+// or at (x0 + i * x_step, y[i]) if x is null
+struct ChartSpan
+{
+	ChartSpan()
+		: x(nullptr)
+		, y(nullptr)
+		, count(0)
+		, x0(0.0f)
+		, x_step(0.0f)
+	{
+	}
+
+	const float* x;
+	const float* y;
+	std::size_t count;
+	float x0;
+	float x_step;
+};
+
+
 class ChartData
 {
 public:
@@ -14,9 +36,32 @@ public:
 
 	virtual std::size_t data_count() const = 0;
 	virtual void data_point(int idx, float* x, float* y) const = 0;
+
+	// Running index of data point 0, for incremental rendering: points are only appended
+	// at the end and dropped at the front, and a point keeps its running index and value
+	// while it is part of the data. Sliding windows increase it when they drop points.
+	virtual std::size_t first_index() const { return 0; }
+
+	// Bulk access to the points from first on without a call per point. Returns false if the
+	// data is not stored in memory, callers use data_point() then. The span may end before
+	// the data does, e.g. where a ring buffer wraps, so callers read spans until they are done.
+	virtual bool data_span(std::size_t, ChartSpan*) const { return false; }
+
+	// number of points ever appended, the running index of the next point
+	std::size_t version() const
+	{
+		return first_index() + data_count();
+	}
+
+	// points appended since version was read, they are the last ones of the data
+	std::size_t appended_since(std::size_t version) const
+	{
+		const std::size_t appended = this->version() - version;
+		return appended < data_count()? appended : data_count();
+	}
 };
 
 
 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,176 @@
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "chart_file.hpp"
+
+
+struct ChartFile::Mapping
+{
+	boost::interprocess::file_mapping file;
+	boost::interprocess::mapped_region region;
+};
+
+
+ChartFile::ChartFile( const std::string& path )
+	: mMapping(new Mapping())
+{
+	using namespace boost::interprocess;
+
+	try
+	{
+		mMapping->file = file_mapping(path.c_str(), read_only);
+		mMapping->region = mapped_region(mMapping->file, read_only);
+	}catch(const interprocess_exception& e)
+	{
+		throw std::runtime_error("can not map chart file '" + path + "': " + e.what());
+	}
+
+	const char* base = static_cast<const char*>(mMapping->region.get_address());
+	const std::uint64_t file_size = mMapping->region.get_size();
+
+	ChartFileHeader header;
+	if(file_size < sizeof(header))
+		throw std::runtime_error("chart file '" + path + "' is truncated");
+	std::memcpy(&header, base, sizeof(header));
+
+	if(std::memcmp(header.magic, CHART_FILE_MAGIC, sizeof(CHART_FILE_MAGIC)) != 0)
+		throw std::runtime_error("'" + path + "' is not a chart file");
+	if(header.version != CHART_FILE_VERSION)
+		throw std::runtime_error("chart file '" + path + "' has unsupported version " + std::to_string(header.version));
+	if(header.byte_order != CHART_FILE_BYTE_ORDER)
+		throw std::runtime_error("chart file '" + path + "' was written with another byte order");
+	if(file_size < sizeof(header) + std::uint64_t(header.chart_count) * sizeof(ChartFileEntry))
+		throw std::runtime_error("chart table of '" + path + "' is truncated");
+
+	for(std::uint32_t idx = 0; idx < header.chart_count; ++idx)
+	{
+		ChartFileEntry entry;
+		std::memcpy(&entry, base + sizeof(header) + idx * sizeof(ChartFileEntry), sizeof(entry));
+
+		if(entry.offset % sizeof(float) != 0
+			|| entry.offset > file_size
+			|| entry.tick_count > (file_size - entry.offset) / sizeof(float))
+		{
+			throw std::runtime_error("chart " + std::to_string(idx) + " of '" + path + "' lies outside of the file");
+		}
+
+		const float* values = reinterpret_cast<const float*>(base + entry.offset);
+		mCharts.emplace_back(new ChartModel(values, std::size_t(entry.tick_count), entry.min_value, entry.max_value, entry.tick_rate));
+	}
+}
+
+ChartFile::~ChartFile()
+{
+	// the views have to go before the mapping
+	mCharts.clear();
+}
+
+std::size_t ChartFile::size() const
+{
+	return mCharts.size();
+}
+
+const ChartModel& ChartFile::chart( std::size_t idx ) const
+{
+	assert(idx < mCharts.size());
+	return *mCharts[idx];
+}
+
+
+
+ChartFileWriter::ChartFileWriter( const std::string& path, std::size_t chart_count )
+	: mStream(path.c_str(), std::ios::binary | std::ios::trunc)
+	, mChartCount(chart_count)
+	, mInChart(false)
+{
+	if(!mStream)
+		throw std::runtime_error("can not open '" + path + "' for writing");
+	// the header stores the count in 32 bit
+	if(chart_count > std::numeric_limits<std::uint32_t>::max())
+		throw std::runtime_error("chart file writer: " + std::to_string(chart_count) + " charts do not fit into a chart file");
+
+	// header and table are written for real in close()
+	std::vector<char> placeholder(sizeof(ChartFileHeader) + chart_count * sizeof(ChartFileEntry), 0);
+	mStream.write(placeholder.data(), placeholder.size());
+}
+
+ChartFileWriter::~ChartFileWriter()
+{
+	if(mStream.is_open())
+	{
+		try
+		{
+			close();
+		}catch(const std::exception&)
+		{
+		}
+	}
+}
+
+void ChartFileWriter::begin_chart( float min_value, float max_value, float tick_rate )
+{
+	if(mInChart || mEntries.size() >= mChartCount)
+		throw std::logic_error("chart file writer: unexpected begin_chart");
+
+	std::uint64_t pos = std::uint64_t(mStream.tellp());
+	const std::uint64_t padding = (CHART_FILE_PAYLOAD_ALIGNMENT - pos % CHART_FILE_PAYLOAD_ALIGNMENT) % CHART_FILE_PAYLOAD_ALIGNMENT;
+	const char zeros[CHART_FILE_PAYLOAD_ALIGNMENT] = {0};
+	mStream.write(zeros, std::streamsize(padding));
+
+	ChartFileEntry entry;
+	entry.offset = pos + padding;
+	entry.tick_count = 0;
+	entry.min_value = min_value;
+	entry.max_value = max_value;
+	entry.tick_rate = tick_rate;
+	entry.reserved = 0;
+	mEntries.push_back(entry);
+	mInChart = true;
+}
+
+void ChartFileWriter::append( const float* values, std::size_t count )
+{
+	assert(mInChart);
+	mStream.write(reinterpret_cast<const char*>(values), std::streamsize(count * sizeof(float)));
+	mEntries.back().tick_count += count;
+}
+
+void ChartFileWriter::end_chart()
+{
+	if(!mInChart)
+		throw std::logic_error("chart file writer: unexpected end_chart");
+	mInChart = false;
+}
+
+void ChartFileWriter::write_chart( const ChartModel& chart )
+{
+	begin_chart(chart.min_value(), chart.max_value(), chart.tick_rate());
+	append(chart.values(), chart.tick_count());
+	end_chart();
+}
+
+void ChartFileWriter::close()
+{
+	if(mInChart || mEntries.size() != mChartCount)
+		throw std::logic_error("chart file writer: closed with " + std::to_string(mEntries.size()) + " of " + std::to_string(mChartCount) + " charts");
+
+	ChartFileHeader header;
+	std::memcpy(header.magic, CHART_FILE_MAGIC, sizeof(CHART_FILE_MAGIC));
+	header.version = CHART_FILE_VERSION;
+	header.chart_count = std::uint32_t(mChartCount);
+	header.byte_order = CHART_FILE_BYTE_ORDER;
+	header.reserved = 0;
+
+	mStream.seekp(0);
+	mStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	mStream.write(reinterpret_cast<const char*>(mEntries.data()), std::streamsize(mEntries.size() * sizeof(ChartFileEntry)));
+	mStream.flush();
+
+	const bool failed = !mStream;
+	mStream.close();
+	if(failed)
+		throw std::runtime_error("writing the chart file failed");
+}
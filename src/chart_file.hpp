@@ -0,0 +1,100 @@
+#pragma once
+#ifndef _CHART_FILE_HPP
+#define _CHART_FILE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include "chart_model.hpp"
+
+
+// Binary chart corpus file, all numbers in the byte order of the machine that wrote it:
+//
+//   ChartFileHeader
+//   ChartFileEntry[chart_count]
+//   payload: tick_count floats per chart, every chart starts at a 64 byte aligned offset
+//
+// The payload is used in place from a read-only memory mapping, so opening even huge
+// files is instant and all threads (and processes) share the pages through the page cache.
+// Files from a machine with another byte order are rejected through the byte order marker.
+
+static const char CHART_FILE_MAGIC[8] = {'A', 'I', 'T', 'C', 'H', 'A', 'R', 'T'};
+static const std::uint32_t CHART_FILE_VERSION = 2;
+static const std::uint32_t CHART_FILE_BYTE_ORDER = 0x01020304;
+static const std::uint64_t CHART_FILE_PAYLOAD_ALIGNMENT = 64;
+
+struct ChartFileHeader
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t chart_count;
+	std::uint32_t byte_order;	// CHART_FILE_BYTE_ORDER as written by the writer
+	std::uint32_t reserved;
+};
+
+struct ChartFileEntry
+{
+	std::uint64_t offset;		// of the first value, from the start of the file
+	std::uint64_t tick_count;
+	float min_value;
+	float max_value;
+	float tick_rate;
+	std::uint32_t reserved;
+};
+
+
+// Maps a chart file and exposes every chart as read-only ChartModel view.
+// Throws std::runtime_error if the file can not be mapped or is malformed.
+class ChartFile
+{
+public:
+	ChartFile(const std::string& path);
+	~ChartFile();
+
+	std::size_t size() const;
+	const ChartModel& chart(std::size_t idx) const;
+
+private:
+	ChartFile(const ChartFile&);
+	ChartFile& operator =(const ChartFile&);
+
+	struct Mapping;
+
+private:
+	std::unique_ptr<Mapping> mMapping;
+	std::vector<std::unique_ptr<const ChartModel>> mCharts;
+};
+
+
+// Writes a chart file chart by chart. The values of a chart are streamed with append(),
+// so charts of any length can be written with constant memory.
+// Throws std::runtime_error if chart_count does not fit into the 32 bit count of the header.
+class ChartFileWriter
+{
+public:
+	ChartFileWriter(const std::string& path, std::size_t chart_count);
+	~ChartFileWriter();
+
+	void begin_chart(float min_value, float max_value, float tick_rate);
+	void append(const float* values, std::size_t count);
+	void end_chart();
+
+	void write_chart(const ChartModel& chart);
+
+	// writes the chart table, has to be called after all announced charts were written
+	void close();
+
+private:
+	ChartFileWriter(const ChartFileWriter&);
+	ChartFileWriter& operator =(const ChartFileWriter&);
+
+private:
+	std::ofstream mStream;
+	std::size_t mChartCount;
+	std::vector<ChartFileEntry> mEntries;
+	bool mInChart;
+};
+
+#endif
@@ -55,6 +55,17 @@ public:
 		*x = float(idx) / mModel->ticks_per_second();
 		*y = mModel->tick_value(idx);
 	}
+
+	virtual bool data_span(std::size_t first, ChartSpan* span) const
+	{
+		const std::size_t count = data_count();
+		span->x = nullptr;
+		span->y = mModel->values() + first;
+		span->count = first < count? count - first : 0;
+		span->x0 = float(first) / mModel->ticks_per_second();
+		span->x_step = 1.0f / mModel->ticks_per_second();
+		return true;
+	}
 private:
 	std::size_t mTime;
 	RealtimeChart* mModel;
@@ -0,0 +1,88 @@
+#include <algorithm>
+#include "chart_generator.hpp"
+#include "philox.hpp"
+
+
+// generates the charts [first_chart, first_chart + Lanes), writes only the first lane_count
+template<std::size_t Lanes>
+static void GenerateLanes( float* values, std::size_t stride, std::size_t tick_count,
+						   std::size_t first_chart, std::size_t lane_count,
+						   float min_value, float max_value, float volatility, std::uint64_t seed )
+{
+	const std::size_t LANES = Lanes;
+	const std::size_t WORDS = Philox4x32::BLOCK_SIZE;
+	const std::uint32_t key0 = std::uint32_t(seed);
+	const std::uint32_t key1 = std::uint32_t(seed >> 32);
+	const float half_step = volatility * (max_value - min_value) / 2.0f;
+
+	float current[LANES] = {};
+	float tile[WORDS][LANES];
+
+	// word 0 of a chart starts the walk, word t + 1 is the step after tick t
+	const std::size_t word_count = tick_count + 1;
+	for(std::uint64_t block = 0; block * WORDS < word_count; ++block)
+	{
+		std::uint32_t ctr[WORDS][LANES];
+		for(std::size_t lane = 0; lane < LANES; ++lane)
+		{
+			const std::uint64_t chart = first_chart + lane;
+			ctr[0][lane] = std::uint32_t(block);
+			ctr[1][lane] = std::uint32_t(block >> 32);
+			ctr[2][lane] = std::uint32_t(chart);
+			ctr[3][lane] = std::uint32_t(chart >> 32);
+		}
+		Philox4x32::blocks(key0, key1, ctr);
+
+		const std::size_t first_word = std::size_t(block) * WORDS;
+		for(std::size_t word = 0; word < WORDS; ++word)
+		{
+			if(first_word + word == 0)
+			{
+				for(std::size_t lane = 0; lane < LANES; ++lane)
+					current[lane] = std::min(max_value, min_value + Philox4x32::to_unit_float(ctr[0][lane]) * (max_value - min_value));
+				continue;
+			}
+
+			for(std::size_t lane = 0; lane < LANES; ++lane)
+			{
+				const float value = current[lane];
+				const float low = std::max(-half_step, min_value - value);
+				const float high = std::min(half_step, max_value - value);
+
+				// the rounding of the step may leave the bounds by an ulp
+				const float next = value + low + Philox4x32::to_unit_float(ctr[word][lane]) * (high - low);
+				tile[word][lane] = value;
+				current[lane] = std::min(max_value, std::max(min_value, next));
+			}
+		}
+
+		// tile[word] holds tick first_word + word - 1
+		const std::size_t word_begin = first_word == 0? 1 : 0;
+		const std::size_t word_end = std::min<std::size_t>(WORDS, word_count - first_word);
+		for(std::size_t lane = 0; lane < lane_count; ++lane)
+		{
+			float* out = values + lane * stride;
+			for(std::size_t word = word_begin; word < word_end; ++word)
+				out[first_word + word - 1] = tile[word][lane];
+		}
+	}
+}
+
+void GenerateWalks( float* values, std::size_t stride, std::size_t tick_count,
+					std::size_t first_chart, std::size_t chart_count,
+					float min_value, float max_value, float volatility, std::uint64_t seed )
+{
+	std::size_t done = 0;
+	for(; done + GENERATOR_LANES <= chart_count; done += GENERATOR_LANES)
+	{
+		GenerateLanes<GENERATOR_LANES>(values + done * stride, stride, tick_count, first_chart + done,
+									   GENERATOR_LANES, min_value, max_value, volatility, seed);
+	}
+
+	// the lanes do not depend on each other, so the rest can be generated one by one with the same result
+	for(; done < chart_count; ++done)
+	{
+		GenerateLanes<1>(values + done * stride, stride, tick_count, first_chart + done,
+						 1, min_value, max_value, volatility, seed);
+	}
+}
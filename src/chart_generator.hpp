@@ -0,0 +1,26 @@
+#pragma once
+#ifndef _CHART_GENERATOR_HPP
+#define _CHART_GENERATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+
+// Bounded random walks: the first value is uniform in [min_value, max_value], every step
+// is uniform in [-v/2, v/2] with v = volatility * (max_value - min_value), cut so the walk
+// stays in [min_value, max_value].
+//
+// Chart first_chart + i is written to values + i * stride. A chart only depends on
+// (seed, chart index), so any range of charts can be generated by any thread and
+// gives bit for bit the same values.
+// GENERATOR_LANES charts are generated together, with the random numbers from
+// Philox4x32 streams (stream = chart index) and the walk as structure of arrays,
+// so both vectorize.
+
+static const std::size_t GENERATOR_LANES = 16;
+
+void GenerateWalks(float* values, std::size_t stride, std::size_t tick_count,
+				   std::size_t first_chart, std::size_t chart_count,
+				   float min_value, float max_value, float volatility, std::uint64_t seed);
+
+#endif
@@ -2,18 +2,49 @@
 #include <cassert>
 #include <cmath>
 #include <algorithm>
+#include <stdexcept>
 #include "chart_model.hpp"
+#include "chart_generator.hpp"
 
 
 ChartModel::ChartModel(float min_vlaue, float max_value, float volatility, std::size_t tick_count)
-	: mMinValue(min_vlaue)
-	, mMaxValue(max_value)
-	, mVolatility(volatility)
+	: mAnalysed(false)
 	, mChartValues(tick_count, 0.0f)
+	, mValues(mChartValues.data())
+	, mTickCount(tick_count)
+	, mTickRate(0.0f)
+	, mVolatility(volatility)
+	, mMinValue(min_vlaue)
+	, mMaxValue(max_value)
 {
 	generate();
 }
 
+ChartModel::ChartModel(float min_vlaue, float max_value, float volatility, std::size_t tick_count, unsigned int seed)
+	: mAnalysed(false)
+	, mChartValues(tick_count, 0.0f)
+	, mValues(mChartValues.data())
+	, mTickCount(tick_count)
+	, mTickRate(0.0f)
+	, mVolatility(volatility)
+	, mMinValue(min_vlaue)
+	, mMaxValue(max_value)
+{
+	generate(seed);
+}
+
+ChartModel::ChartModel(const float* values, std::size_t tick_count, float min_value, float max_value, float tick_rate)
+	: mAnalysed(false)
+	, mValues(values)
+	, mTickCount(tick_count)
+	, mTickRate(tick_rate)
+	, mVolatility(0.0f)
+	, mMinValue(min_value)
+	, mMaxValue(max_value)
+{
+	assert(mValues || mTickCount == 0);
+}
+
 ChartModel::~ChartModel()
 {
 
@@ -31,12 +62,28 @@ float ChartModel::max_value() const
 
 float ChartModel::value(std::size_t tick ) const
 {
-	return mChartValues.at(tick);
+	assert(tick < mTickCount);
+	return mValues[tick];
 }
 
 std::size_t ChartModel::tick_count() const
 {
-	return mChartValues.size();
+	return mTickCount;
+}
+
+const float* ChartModel::values() const
+{
+	return mValues;
+}
+
+float ChartModel::tick_rate() const
+{
+	return mTickRate;
+}
+
+bool ChartModel::is_view() const
+{
+	return mValues != mChartValues.data();
 }
 
 void ChartModel::generate()
@@ -46,39 +93,80 @@ void ChartModel::generate()
 
 void ChartModel::generate(unsigned int seed)
 {
-	const float abs_vol = mVolatility * (max_value() - min_value());
-	typedef std::uniform_real_distribution<float> distribution_type;
-	std::default_random_engine generator(seed);
-	distribution_type absolute_distribution(min_value(), max_value());
-	distribution_type delta_distribution(min_value() / 3.0f, max_value() / 3.0f);
+	generate(seed, 0);
+}
 
-	auto abs_rand = [&]() { return absolute_distribution(generator); };
-	auto rel_rand = [&]() { return delta_distribution(generator); };
+void ChartModel::generate( std::uint64_t seed, std::size_t chart_index )
+{
+	if(is_view())
+		throw std::logic_error("can not generate into a read-only chart view");
 
-	float cur_value = abs_rand();
+	GenerateWalks(mChartValues.data(), mTickCount, mTickCount, chart_index, 1, min_value(), max_value(), mVolatility, seed);
 
-	for(auto& value : mChartValues)
-	{
-		value = cur_value;
+	mAnalysed = false;
+}
 
-		float min = std::max(-abs_vol/ 2.0f, min_value() - cur_value);
-		float max = std::min(abs_vol/2.0f, max_value() - cur_value);
-		assert(cur_value + min >= min_value());
-		assert(cur_value + max <= max_value());
+float ChartModel::max_long_yield() const
+{
+	_ensure_analysed();
+	return mMaxLongYield;
+}
 
-		delta_distribution = distribution_type(min, max);
-		cur_value += rel_rand();
-	}
+float ChartModel::max_short_yield() const
+{
+	_ensure_analysed();
+	return mMaxShortYield;
+}
+
+float ChartModel::max_yield() const
+{
+	_ensure_analysed();
+	return std::max(mMaxLongYield, mMaxShortYield);
+}
 
-	calc_max_yield();
+float ChartModel::normalized_yield( float profit ) const
+{
+	const float best = max_yield();
+	return best > 0.0f? profit / best : 0.0f;
 }
 
-/*float ChartModel::max_yield() const
+const RangeExtrema& ChartModel::extrema() const
 {
-	return *mMaxYield;
-}*/
+	_ensure_analysed();
+	return mExtrema;
+}
 
-void ChartModel::calc_max_yield()
+void ChartModel::_ensure_analysed() const
 {
+	if(mAnalysed.load(std::memory_order_acquire))
+		return;
+
+	std::lock_guard<std::mutex> lock(mAnalyseMutex);
+	if(!mAnalysed.load(std::memory_order_relaxed))
+	{
+		analyse();
+		mAnalysed.store(true, std::memory_order_release);
+	}
+}
+
+void ChartModel::analyse() const
+{
+	// one pass: the best trade closing at a tick opens at the lowest (long) or highest (short) value before it
+	mMaxLongYield = 0.0f;
+	mMaxShortYield = 0.0f;
+	if(mTickCount)
+	{
+		float low = mValues[0];
+		float high = mValues[0];
+		for(std::size_t tick = 1; tick < mTickCount; ++tick)
+		{
+			const float value = mValues[tick];
+			mMaxLongYield = std::max(mMaxLongYield, value - low);
+			mMaxShortYield = std::max(mMaxShortYield, high - value);
+			low = std::min(low, value);
+			high = std::max(high, value);
+		}
+	}
 
+	mExtrema.build(mValues, mTickCount);
 }
@@ -2,14 +2,23 @@
 #define _CHART_MODEL_HPP
 
 #include <vector>
+#include <cstdint>
 #include <random>
 #include <memory>
+#include <mutex>
+#include <atomic>
 #include "chart_data.hpp"
+#include "range_extrema.hpp"
 
 class ChartModel
 {
 public:
 	ChartModel(float min_vlaue, float max_value, float volatility, std::size_t tick_count);
+	ChartModel(float min_vlaue, float max_value, float volatility, std::size_t tick_count, unsigned int seed);
+
+	// read-only view on tick_count values owned by someone else (e.g. a mapped ChartFile),
+	// the values are not touched before they are used
+	ChartModel(const float* values, std::size_t tick_count, float min_value, float max_value, float tick_rate);
 	~ChartModel();
 
 	float min_value() const;
@@ -17,17 +26,46 @@ public:
 
 	float value(std::size_t tick) const;
 	std::size_t tick_count() const;
+	const float* values() const;
+
+	// ticks per second of recorded charts, 0 if unknown
+	float tick_rate() const;
+	bool is_view() const;
 
 	void generate();
 	void generate(unsigned int seed);
+	// the chart chart_index of GenerateWalks with the seed
+	void generate(std::uint64_t seed, std::size_t chart_index);
+
+	// The yields and extrema below are computed on the first call of any of them, O(n) once.
+	// That may happen from several threads at once.
 
-	//float max_yield() const;
+	// best profit of a single long (buy low, sell later higher) or short trade, without charges
+	float max_long_yield() const;
+	float max_short_yield() const;
+	float max_yield() const;
+	// profit relative to max_yield(), 0 if the chart is flat
+	float normalized_yield(float profit) const;
+
+	// O(1) range queries over the values
+	const RangeExtrema& extrema() const;
 
 private:
-	void calc_max_yield();
+	ChartModel(const ChartModel&);
+	ChartModel& operator =(const ChartModel&);
+
+	void _ensure_analysed() const;
+	void analyse() const;
 private:
-	std::unique_ptr<float> mMaxYield;
+	mutable std::atomic<bool> mAnalysed;
+	mutable std::mutex mAnalyseMutex;
+	mutable float mMaxLongYield;
+	mutable float mMaxShortYield;
+	mutable RangeExtrema mExtrema;
 	std::vector<float> mChartValues;
+	const float* mValues;
+	std::size_t mTickCount;
+	float mTickRate;
 	float mVolatility;
 	float mMinValue;
 	float mMaxValue;
@@ -0,0 +1,217 @@
+#pragma once
+#ifndef _CHART_PLOT_HPP
+#define _CHART_PLOT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "chart_data.hpp"
+#include "chart_pyramid.hpp"
+#include "utils.hpp"
+
+
+// The line strip of a ChartData, independent of the graphics library.
+// VertexFactory is a policy with a vertex_type typedef and vertex_type operator ()(float x, float y),
+// so the renderer gets vertices it can draw without another copy.
+//
+// Only points that were appended since the last update are converted to vertices. The vertices
+// keep the data coordinates, so a change of the y range never needs a rebuild.
+// If the visible points outnumber the pixel columns, only the extrema of every column are shown.
+template<typename VertexFactory>
+class ChartPlot
+{
+public:
+	typedef typename VertexFactory::vertex_type vertex_type;
+
+public:
+	ChartPlot(const ChartData* data, const VertexFactory& factory = VertexFactory())
+		: mData(data)
+		, mFactory(factory)
+		, mFirstVertex(0)
+		, mFirstIndex(0)
+		, mShowsColumns(false)
+	{
+	}
+
+	// follows the data, column_count is the number of pixel columns of the viewport
+	void update(std::size_t column_count)
+	{
+		const std::size_t count = mData->data_count();
+		const std::size_t first = mData->first_index();
+
+		_update_pyramid(first, count);
+		_build_columns(count, column_count);
+
+		if(mShowsColumns)
+		{
+			// the points are converted again when they are shown again
+			mVertexList.clear();
+			mFirstVertex = 0;
+			mFirstIndex = 0;
+		}else{
+			const std::size_t shown_end = mFirstIndex + (mVertexList.size() - mFirstVertex);
+			if(first < mFirstIndex || first > shown_end || first + count < shown_end)
+			{
+				// not a sliding window of the shown points
+				_rebuild();
+			}else{
+				_drop_points(first - mFirstIndex);
+				_append_points(shown_end - first, count);
+			}
+		}
+	}
+
+	// the line strip to draw, two vertices (minimum and maximum) per column if shows_columns()
+	const vertex_type* vertices() const
+	{
+		return mShowsColumns? mColumnVertices.data() : mVertexList.data() + mFirstVertex;
+	}
+
+	std::size_t vertex_count() const
+	{
+		return mShowsColumns? mColumnVertices.size() : mVertexList.size() - mFirstVertex;
+	}
+
+	bool shows_columns() const
+	{
+		return mShowsColumns;
+	}
+
+private:
+	ChartPlot(const ChartPlot&);
+	ChartPlot& operator =(const ChartPlot&);
+
+	void _rebuild()
+	{
+		mVertexList.clear();
+		mFirstVertex = 0;
+		mFirstIndex = mData->first_index();
+		_append_points(0, mData->data_count());
+	}
+
+	void _append_points(std::size_t first, std::size_t count)
+	{
+		// in bulk as long as the data gives spans
+		ChartSpan span;
+		while(first < count && mData->data_span(first, &span) && span.count > 0)
+		{
+			const std::size_t span_count = std::min(span.count, count - first);
+			for(std::size_t idx = 0; idx < span_count; ++idx)
+			{
+				const float x = span.x? span.x[idx] : span.x0 + float(idx) * span.x_step;
+				mVertexList.push_back(mFactory(x, span.y[idx]));
+			}
+			first += span_count;
+		}
+
+		for(std::size_t idx = first; idx < count; ++idx)
+		{
+			float x,y;
+			mData->data_point(int(idx), &x, &y);
+
+			mVertexList.push_back(mFactory(x, y));
+		}
+	}
+
+	void _drop_points(std::size_t count)
+	{
+		mFirstVertex += count;
+		mFirstIndex += count;
+
+		if(mFirstVertex * 2 > mVertexList.size())
+		{
+			mVertexList.erase(mVertexList.begin(), mVertexList.begin() + mFirstVertex);
+			mFirstVertex = 0;
+		}
+	}
+
+	void _update_pyramid(std::size_t first, std::size_t count)
+	{
+		const std::size_t end = first + count;
+		if(first < mPyramid.begin_index() || first > mPyramid.end_index() || end < mPyramid.end_index())
+		{
+			mPyramid.clear(first);
+		}else{
+			mPyramid.drop_front(first);
+		}
+		_append_to_pyramid(mPyramid.end_index() - first, count);
+	}
+
+	void _append_to_pyramid(std::size_t first, std::size_t count)
+	{
+		ChartSpan span;
+		while(first < count && mData->data_span(first, &span) && span.count > 0)
+		{
+			const std::size_t span_count = std::min(span.count, count - first);
+			mPyramid.append(span.y, span_count);
+			first += span_count;
+		}
+
+		for(; first < count; ++first)
+		{
+			float x,y;
+			mData->data_point(int(first), &x, &y);
+			mPyramid.append(&y, 1);
+		}
+	}
+
+	// Decimates the visible points to a minimum and a maximum per pixel column, if there are
+	// more than two points per column. The points have to be evenly spaced in x.
+	void _build_columns(std::size_t count, std::size_t columns)
+	{
+		mShowsColumns = false;
+		mColumnVertices.clear();
+
+		if(count <= 2 * columns)
+			return;
+
+		float x_first, x_last, y;
+		mData->data_point(0, &x_first, &y);
+		mData->data_point(int(count - 1), &x_last, &y);
+		const float step = (x_last - x_first) / float(count - 1);
+		if(!(step > 0.0f))
+			return;
+
+		const float visible_first = std::floor((mData->min_x() - x_first) / step);
+		const float visible_last = std::ceil((mData->max_x() - x_first) / step) + 1.0f;
+		const std::size_t first = std::size_t(between(0.0f, visible_first, float(count)));
+		const std::size_t last = std::size_t(between(0.0f, visible_last, float(count)));
+		const std::size_t visible = last > first? last - first : 0;
+		if(visible <= 2 * columns)
+			return;
+
+		const std::size_t first_index = mData->first_index();
+		mColumnVertices.reserve(2 * columns);
+		for(std::size_t column = 0; column < columns; ++column)
+		{
+			const std::size_t begin = first + visible * column / columns;
+			const std::size_t end = first + visible * (column + 1) / columns;
+
+			float low, high;
+			mPyramid.range_extrema(*mData, first_index + begin, first_index + end, &low, &high);
+
+			const float x = x_first + step * 0.5f * float(begin + end - 1);
+			mColumnVertices.push_back(mFactory(x, low));
+			mColumnVertices.push_back(mFactory(x, high));
+		}
+		mShowsColumns = true;
+	}
+
+private:
+	const ChartData* mData;
+	VertexFactory mFactory;
+
+	// vertices before mFirstVertex belong to dropped points, they are erased in bulk
+	// once they make up half of the list, so the strip stays contiguous for one draw call
+	std::vector<vertex_type> mVertexList;
+	std::size_t mFirstVertex;
+	// running index of the point at mFirstVertex
+	std::size_t mFirstIndex;
+
+	ChartPyramid mPyramid;
+	std::vector<vertex_type> mColumnVertices;
+	bool mShowsColumns;
+};
+
+
+#endif
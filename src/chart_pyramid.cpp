@@ -0,0 +1,189 @@
+#include <cassert>
+#include <algorithm>
+#include "chart_pyramid.hpp"
+
+
+ChartPyramid::ChartPyramid()
+{
+	clear(0);
+}
+
+ChartPyramid::~ChartPyramid()
+{
+}
+
+void ChartPyramid::clear( std::size_t first_index )
+{
+	mBeginIndex = first_index;
+	mEndIndex = first_index;
+	mLevels.clear();
+	mPartialCount = 0;
+	mPartialMin = 0.0f;
+	mPartialMax = 0.0f;
+}
+
+std::size_t ChartPyramid::begin_index() const
+{
+	return mBeginIndex;
+}
+
+std::size_t ChartPyramid::end_index() const
+{
+	return mEndIndex;
+}
+
+void ChartPyramid::append( const float* values, std::size_t count )
+{
+	for(std::size_t idx = 0; idx < count; ++idx)
+	{
+		const float value = values[idx];
+		const std::size_t offset = mEndIndex % BASE_BUCKET_SIZE;
+		if(offset == 0)
+			mPartialCount = 0;
+
+		mPartialMin = mPartialCount? std::min(mPartialMin, value) : value;
+		mPartialMax = mPartialCount? std::max(mPartialMax, value) : value;
+		++mPartialCount;
+		++mEndIndex;
+
+		// the bucket the pyramid started in misses its first points
+		if(offset + 1 == BASE_BUCKET_SIZE && mPartialCount == BASE_BUCKET_SIZE)
+			_push_bucket(0, mEndIndex / BASE_BUCKET_SIZE - 1, mPartialMin, mPartialMax);
+	}
+}
+
+void ChartPyramid::drop_front( std::size_t first_index )
+{
+	for(std::size_t level = 0; level < mLevels.size(); ++level)
+	{
+		Level& l = mLevels[level];
+		const std::size_t first_bucket = first_index / (BASE_BUCKET_SIZE << level);
+		if(first_bucket <= l.base)
+			continue;
+
+		const std::size_t dead = std::min(first_bucket - l.base, l.min.size());
+		if(dead * 2 > l.min.size())
+		{
+			l.min.erase(l.min.begin(), l.min.begin() + dead);
+			l.max.erase(l.max.begin(), l.max.begin() + dead);
+			l.base += dead;
+		}
+	}
+}
+
+void ChartPyramid::range_extrema( const ChartData& data, std::size_t first, std::size_t last, float* min_value, float* max_value ) const
+{
+	assert(first < last && last <= mEndIndex);
+
+	std::size_t bucket_begin = (first + BASE_BUCKET_SIZE - 1) / BASE_BUCKET_SIZE;
+	std::size_t bucket_end = last / BASE_BUCKET_SIZE;
+
+	if(bucket_begin >= bucket_end)
+	{
+		_scan(data, first, last, min_value, max_value);
+		return;
+	}
+
+	float low = 0.0f;
+	float high = 0.0f;
+	bool found = false;
+	auto add = [&](float bucket_min, float bucket_max)
+	{
+		low = found? std::min(low, bucket_min) : bucket_min;
+		high = found? std::max(high, bucket_max) : bucket_max;
+		found = true;
+	};
+
+	// like a segment tree: the odd bucket at either end is taken, the rest goes one level up
+	for(std::size_t level = 0; bucket_begin < bucket_end; ++level)
+	{
+		const Level& l = mLevels[level];
+		if(bucket_begin & 1)
+		{
+			add(l.min[bucket_begin - l.base], l.max[bucket_begin - l.base]);
+			++bucket_begin;
+		}
+		if(bucket_end & 1)
+		{
+			--bucket_end;
+			add(l.min[bucket_end - l.base], l.max[bucket_end - l.base]);
+		}
+		bucket_begin >>= 1;
+		bucket_end >>= 1;
+	}
+
+	float edge_min, edge_max;
+	const std::size_t head_end = (first + BASE_BUCKET_SIZE - 1) / BASE_BUCKET_SIZE * BASE_BUCKET_SIZE;
+	if(first < head_end)
+	{
+		_scan(data, first, head_end, &edge_min, &edge_max);
+		add(edge_min, edge_max);
+	}
+	const std::size_t tail_begin = last / BASE_BUCKET_SIZE * BASE_BUCKET_SIZE;
+	if(tail_begin < last)
+	{
+		_scan(data, tail_begin, last, &edge_min, &edge_max);
+		add(edge_min, edge_max);
+	}
+
+	*min_value = low;
+	*max_value = high;
+}
+
+void ChartPyramid::_push_bucket( std::size_t level, std::size_t bucket, float min_value, float max_value )
+{
+	if(level == mLevels.size())
+		mLevels.push_back(Level());
+
+	Level& l = mLevels[level];
+	if(l.min.empty() || bucket != l.base + l.min.size())
+	{
+		// the buckets before a gap contain dropped points only
+		l.min.clear();
+		l.max.clear();
+		l.base = bucket;
+	}
+	l.min.push_back(min_value);
+	l.max.push_back(max_value);
+
+	// every odd bucket completes one of the next level, if its partner was not dropped
+	if((bucket & 1) && bucket > l.base)
+	{
+		const std::size_t last = l.min.size() - 1;
+		_push_bucket(level + 1, bucket >> 1, std::min(l.min[last - 1], l.min[last]), std::max(l.max[last - 1], l.max[last]));
+	}
+}
+
+void ChartPyramid::_scan( const ChartData& data, std::size_t first, std::size_t last, float* min_value, float* max_value )
+{
+	assert(first < last);
+	const std::size_t data_first = data.first_index();
+	std::size_t idx = first - data_first;
+	const std::size_t end = last - data_first;
+
+	float x, y;
+	data.data_point(int(idx), &x, &y);
+	float low = y;
+	float high = y;
+
+	ChartSpan span;
+	while(idx < end && data.data_span(idx, &span) && span.count > 0)
+	{
+		const std::size_t count = std::min(span.count, end - idx);
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			low = std::min(low, span.y[i]);
+			high = std::max(high, span.y[i]);
+		}
+		idx += count;
+	}
+	for(; idx < end; ++idx)
+	{
+		data.data_point(int(idx), &x, &y);
+		low = std::min(low, y);
+		high = std::max(high, y);
+	}
+
+	*min_value = low;
+	*max_value = high;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#ifndef _CHART_PYRAMID_HPP
+#define _CHART_PYRAMID_HPP
+
+#include <cstddef>
+#include <vector>
+#include "chart_data.hpp"
+
+
+// Multi-resolution minimum and maximum of the y values of a ChartData, for drawing
+// series that have more points than the viewport has pixel columns.
+// Level l holds the extrema of the buckets of BASE_BUCKET_SIZE * 2^l points, keyed by the
+// running index of the points. Appending is amortized O(1) per point, and the extrema of
+// any range are combined from at most two buckets per level plus the unaligned points at
+// both ends, which are read from the data. Only complete buckets are stored, so
+// points in the buckets never change, and buckets of dropped points are released in bulk.
+class ChartPyramid
+{
+public:
+	static const std::size_t BASE_BUCKET_SIZE = 16;
+
+public:
+	ChartPyramid();
+	~ChartPyramid();
+
+	// forgets everything, the next appended point has the running index first_index
+	void clear(std::size_t first_index);
+	// running index of the first point appended since clear()
+	std::size_t begin_index() const;
+	// running index of the next point to append
+	std::size_t end_index() const;
+
+	void append(const float* values, std::size_t count);
+	// points before first_index are not queried anymore
+	void drop_front(std::size_t first_index);
+
+	// extrema of the running indices [first, last), which must be part of the data and appended
+	void range_extrema(const ChartData& data, std::size_t first, std::size_t last, float* min_value, float* max_value) const;
+
+private:
+	struct Level
+	{
+		Level()
+			: base(0)
+		{
+		}
+
+		// bucket number of min[0] and max[0]
+		std::size_t base;
+		std::vector<float> min;
+		std::vector<float> max;
+	};
+
+	void _push_bucket(std::size_t level, std::size_t bucket, float min_value, float max_value);
+	static void _scan(const ChartData& data, std::size_t first, std::size_t last, float* min_value, float* max_value);
+
+private:
+	std::size_t mBeginIndex;
+	std::size_t mEndIndex;
+	std::vector<Level> mLevels;
+	// the points of the incomplete base bucket that were appended
+	std::size_t mPartialCount;
+	float mPartialMin;
+	float mPartialMax;
+};
+
+
+#endif
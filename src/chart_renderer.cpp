@@ -1,14 +1,17 @@
 #include "chart_renderer.hpp"
 
 
+// columns if no render rect is set, the width of the default window
+static const std::size_t DEFAULT_COLUMN_COUNT = 800;
 
 
 
 ChartRenderer::ChartRenderer( const ChartData* data, const sf::FloatRect& render_rect )
-	: mData(data)
-	, mRenderRect(render_rect)
-	, mHasUpdate(true)
+	: mHasUpdate(true)
 	, mShowAxes(true)
+	, mRenderRect(render_rect)
+	, mData(data)
+	, mPlot(data)
 {
 
 }
@@ -47,12 +50,12 @@ void ChartRenderer::render(sf::RenderTarget& target)
 	sf::View oldView = target.getView();
 	{
 		target.setView(mView);
-		target.draw(mVertexList.data(), mVertexList.size(), sf::LinesStrip);
+		target.draw(mPlot.vertices(), mPlot.vertex_count(), sf::LinesStrip);
 
 		sf::Vertex line[] =
 		{
-			sf::Vertex(sf::Vector2f(mView.getCenter().x - mView.getSize().x, mView.getCenter().y * 2)),
-			sf::Vertex(sf::Vector2f(mView.getCenter().x + mView.getSize().x, mView.getCenter().y * 2))
+			sf::Vertex(sf::Vector2f(mView.getCenter().x - mView.getSize().x, 0.0f)),
+			sf::Vertex(sf::Vector2f(mView.getCenter().x + mView.getSize().x, 0.0f))
 		};
 
 		target.draw(line, 2, sf::LinesStrip);
@@ -65,26 +68,20 @@ void ChartRenderer::notifiy_update()
 	mHasUpdate = true;
 }
 
+// The view flips the y axis, so a change of the y range only changes the view.
 void ChartRenderer::update()
 {
-	mVertexList.clear();
-
-	unsigned int count = mData->data_count();
+	mPlot.update(_column_count());
 
 	sf::Vector2f size(mData->max_x() - mData->min_x(), mData->max_y() - mData->min_y());
 	sf::Vector2f center(mData->min_x() + size.x * 0.5f,
 						mData->min_y() + size.y * 0.5f);
 
-
-	float top = mData->max_y();
-	mView = sf::View(center, size);
-
-	for(std::size_t idx = 0; idx < count; ++idx)
-	{
-		float x,y;
-		mData->data_point(idx, &x, &y);
-
-		mVertexList.emplace_back(sf::Vector2f(x, center.y * 2 - y));
-	}
+	mView = sf::View(center, sf::Vector2f(size.x, -size.y));
 	mHasUpdate = false;
 }
+
+std::size_t ChartRenderer::_column_count() const
+{
+	return mRenderRect.width >= 1.0f? std::size_t(mRenderRect.width) : DEFAULT_COLUMN_COUNT;
+}
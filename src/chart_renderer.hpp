@@ -9,8 +9,20 @@
 #include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/Vertex.hpp>
 #include "chart_data.hpp"
+#include "chart_plot.hpp"
 
 
+// the vertices of the plot are drawn as they are
+struct ChartVertexFactory
+{
+	typedef sf::Vertex vertex_type;
+
+	sf::Vertex operator ()(float x, float y) const
+	{
+		return sf::Vertex(sf::Vector2f(x, y));
+	}
+};
+
 class ChartRenderer
 {
 public:
@@ -28,6 +40,7 @@ public:
 
 private:
 	void update();
+	std::size_t _column_count() const;
 
 private:
 	bool mHasUpdate;
@@ -36,7 +49,7 @@ private:
 	const ChartData* mData;
 
 	sf::View mView;
-	std::vector<sf::Vertex> mVertexList;
+	ChartPlot<ChartVertexFactory> mPlot;
 };
 
 
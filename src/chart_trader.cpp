@@ -14,72 +14,38 @@ Order::OrderType Order::type() const
 
 bool Order::active() const
 {
-	return mActive;
+	return mTrader->mBasicTrader.active(::OrderType(mOrderType));
 }
 
 void Order::breach()
 {
-	assert(!mActive);
-	mEntrance = mTrader->mChart->current_value();
-
-	assert(mEntrance >= 0.0f);
-
-	//mTrader->mCapital -= mEntrance;
-	mTrader->mCapital -= mChargeFunction(mEntrance);
-	mActive = true;
+	mTrader->mBasicTrader.breach(::OrderType(mOrderType), mTrader->mChart->current_value());
 }
 
 float Order::leave()
 {
-	assert(mActive);
-
-	float& capital = mTrader->mCapital;
-	float old_capital = capital;
-	float cur_value = mTrader->mChart->current_value();
-	float diff = cur_value - mEntrance;
-
-	// charges
-	capital -= mChargeFunction(cur_value);
-
-	switch (mOrderType)
-	{
-	case Long:
-		capital += diff;
-		break;
-	case Short:
-		capital -= diff;
-		break;
-	default:
-		throw std::exception("Unknown order type");
-	}
-
-	mActive = false;
-	return capital - old_capital;
+	return mTrader->mBasicTrader.leave(::OrderType(mOrderType), mTrader->mChart->current_value());
 }
 
-Order::Order( OrderType type, ChartTrader* trader, ChargeFunction charge_function )
+Order::Order( OrderType type, ChartTrader* trader )
 	: mOrderType(type)
 	, mTrader(trader)
-	, mChargeFunction(charge_function)
-	, mEntrance(0.0f)
-	, mActive(false)
 {
 }
 
 float Order::entrance() const
 {
-	assert(active());
-	return mEntrance;
+	return mTrader->mBasicTrader.entrance(::OrderType(mOrderType));
 }
 
 
 ChartTrader::ChartTrader( WalkingChart* chart, float capital, ChargeFunction charge_function)
 	: mChart(chart)
-	, mCapital(capital)
-	, mLongOrder(Order::Long, this, charge_function)
-	, mShortOrder(Order::Short, this, charge_function)
+	, mBasicTrader(capital, charge_function)
+	, mShortOrder(Order::Short, this)
+	, mLongOrder(Order::Long, this)
 {
-
+	assert(mChart);
 }
 
 ChartTrader::~ChartTrader()
@@ -88,7 +54,7 @@ ChartTrader::~ChartTrader()
 
 float ChartTrader::capital() const
 {
-	return mCapital;
+	return mBasicTrader.capital();
 }
 
 Order& ChartTrader::short_order()
@@ -113,5 +79,5 @@ const Order& ChartTrader::long_order() const
 
 bool ChartTrader::is_trading() const
 {
-	return long_order().active() || short_order().active();
+	return mBasicTrader.is_trading();
 }
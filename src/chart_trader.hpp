@@ -3,6 +3,7 @@
 #define _CHART_TRADER_HPP
 
 #include <functional>
+#include "basic_trader.hpp"
 
 class WalkingChart;
 class ChartTrader;
@@ -15,8 +16,8 @@ class Order
 public:
 	enum OrderType
 	{
-		Short,
-		Long
+		Short = ShortOrder,
+		Long = LongOrder
 	};
 public:
 	~Order();
@@ -30,18 +31,17 @@ public:
 	float entrance() const;
 
 private:
-	Order(OrderType type, ChartTrader* trader, ChargeFunction charge_function);
+	Order(OrderType type, ChartTrader* trader);
 
 private:
 	const OrderType mOrderType;
 	ChartTrader* mTrader;
-	bool mActive;
-	float mEntrance;
-	const ChargeFunction mChargeFunction;;
 };
 
 
 
+// BasicTrader behind a type-erased charge function, trading at the current value of a
+// WalkingChart. Used by the interactive game, simulations use BasicTrader directly.
 class ChartTrader
 {
 	friend class Order;
@@ -59,7 +59,7 @@ public:
 
 private:
 	WalkingChart* mChart;
-	float mCapital;
+	BasicTrader<ChargeFunction> mBasicTrader;
 	Order mShortOrder;
 	Order mLongOrder;
 };
@@ -0,0 +1,51 @@
+#include <cassert>
+#include "genome_arena.hpp"
+
+
+static std::size_t GenomeStride( std::size_t genome_size )
+{
+	const std::size_t per_line = MEMORY_ALIGNMENT / sizeof(GenomeArena::weight_type);
+	return (genome_size + per_line - 1) / per_line * per_line;
+}
+
+
+GenomeArena::GenomeArena( std::size_t genome_size, std::size_t capacity )
+	: mGenomeSize(genome_size)
+	, mStride(GenomeStride(genome_size))
+	, mCapacity(capacity)
+	, mWeights(Array<weight_type>::New(mStride * capacity))
+{
+	// keep the padding defined, it is streamed together with the genomes
+	std::fill(mWeights.begin(), mWeights.end(), weight_type(0));
+}
+
+GenomeArena::~GenomeArena()
+{
+}
+
+std::size_t GenomeArena::genome_size() const
+{
+	return mGenomeSize;
+}
+
+std::size_t GenomeArena::capacity() const
+{
+	return mCapacity;
+}
+
+std::size_t GenomeArena::stride() const
+{
+	return mStride;
+}
+
+GenomeArena::weight_type* GenomeArena::genome( std::size_t idx )
+{
+	assert(idx < mCapacity);
+	return mWeights.data() + idx * mStride;
+}
+
+const GenomeArena::weight_type* GenomeArena::genome( std::size_t idx ) const
+{
+	assert(idx < mCapacity);
+	return mWeights.data() + idx * mStride;
+}
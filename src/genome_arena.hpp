@@ -0,0 +1,42 @@
+#pragma once
+#ifndef _GENOME_ARENA_HPP
+#define _GENOME_ARENA_HPP
+
+#include <cstddef>
+#include "array.hpp"
+
+
+// The weights of a whole population in one aligned block.
+// Every genome starts at a MEMORY_ALIGNMENT boundary, the gap up to the next
+// genome is padding. The arena never reallocates, so entities can keep plain
+// pointers to their genome for the lifetime of the arena.
+class GenomeArena
+{
+public:
+	typedef float weight_type;
+
+public:
+	GenomeArena(std::size_t genome_size, std::size_t capacity);
+	~GenomeArena();
+
+	std::size_t genome_size() const;
+	std::size_t capacity() const;
+	// distance between two genomes in weights
+	std::size_t stride() const;
+
+	weight_type* genome(std::size_t idx);
+	const weight_type* genome(std::size_t idx) const;
+
+private:
+	GenomeArena(const GenomeArena&);
+	GenomeArena& operator =(const GenomeArena&);
+
+private:
+	const std::size_t mGenomeSize;
+	const std::size_t mStride;
+	const std::size_t mCapacity;
+	Array<weight_type> mWeights;
+};
+
+
+#endif
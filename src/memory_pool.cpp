@@ -0,0 +1,163 @@
+#include <cassert>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include "memory_pool.hpp"
+
+#ifdef _MSC_VER
+#	include <malloc.h>
+#endif
+
+
+void* AlignedAlloc(std::size_t bytes)
+{
+	void* ptr = nullptr;
+#ifdef _MSC_VER
+	ptr = _aligned_malloc(bytes, MEMORY_ALIGNMENT);
+#else
+	if(posix_memalign(&ptr, MEMORY_ALIGNMENT, bytes) != 0)
+		ptr = nullptr;
+#endif
+	if(!ptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void AlignedFree(void* ptr)
+{
+#ifdef _MSC_VER
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+
+
+void* HeapAllocator::allocate(std::size_t bytes)
+{
+	return AlignedAlloc(bytes);
+}
+
+void HeapAllocator::deallocate(void* ptr, std::size_t)
+{
+	AlignedFree(ptr);
+}
+
+
+
+static const std::size_t POOL_CLASS_COUNT = 11;
+// all size classes of a thread together, blocks freed beyond it go back to the heap
+static const std::size_t POOL_THREAD_CACHE_BYTES = 4 * 1024 * 1024;
+
+static std::size_t SizeClass(std::size_t bytes)
+{
+	std::size_t cls = 0;
+	std::size_t block = PoolAllocator::min_block_size;
+	while(block < bytes)
+	{
+		block <<= 1;
+		++cls;
+	}
+	return cls;
+}
+
+static std::size_t ClassBlockSize(std::size_t cls)
+{
+	return PoolAllocator::min_block_size << cls;
+}
+
+class ThreadCache
+{
+public:
+	ThreadCache();
+	~ThreadCache();
+
+	void* pop(std::size_t cls)
+	{
+		auto& list = mFreeLists[cls];
+		if(list.empty())
+			return nullptr;
+
+		void* ptr = list.back();
+		list.pop_back();
+		mCachedBytes -= ClassBlockSize(cls);
+		return ptr;
+	}
+
+	bool push(std::size_t cls, void* ptr)
+	{
+		const std::size_t block_size = ClassBlockSize(cls);
+		if(mCachedBytes + block_size > POOL_THREAD_CACHE_BYTES)
+			return false;
+
+		mFreeLists[cls].push_back(ptr);
+		mCachedBytes += block_size;
+		return true;
+	}
+
+private:
+	std::vector<void*> mFreeLists[POOL_CLASS_COUNT];
+	std::size_t mCachedBytes;
+};
+
+// stays valid after the cache of the thread was destroyed, so late frees can bypass it
+static thread_local bool GThreadCacheDestroyed = false;
+
+ThreadCache::ThreadCache()
+	: mCachedBytes(0)
+{
+}
+
+ThreadCache::~ThreadCache()
+{
+	for(auto& list : mFreeLists)
+	{
+		for(void* ptr : list)
+			AlignedFree(ptr);
+		list.clear();
+	}
+	mCachedBytes = 0;
+	GThreadCacheDestroyed = true;
+}
+
+static ThreadCache* LocalCache()
+{
+	if(GThreadCacheDestroyed)
+		return nullptr;
+
+	static thread_local ThreadCache cache;
+	return &cache;
+}
+
+void* PoolAllocator::allocate(std::size_t bytes)
+{
+	if(bytes > max_block_size)
+		return AlignedAlloc(bytes);
+
+	const std::size_t cls = SizeClass(bytes);
+	assert(cls < POOL_CLASS_COUNT);
+
+	ThreadCache* cache = LocalCache();
+	if(cache)
+	{
+		void* ptr = cache->pop(cls);
+		if(ptr)
+			return ptr;
+	}
+	return AlignedAlloc(ClassBlockSize(cls));
+}
+
+void PoolAllocator::deallocate(void* ptr, std::size_t bytes)
+{
+	if(!ptr)
+		return;
+
+	if(bytes <= max_block_size)
+	{
+		ThreadCache* cache = LocalCache();
+		if(cache && cache->push(SizeClass(bytes), ptr))
+			return;
+	}
+	AlignedFree(ptr);
+}
@@ -0,0 +1,41 @@
+#pragma once
+#ifndef _MEMORY_POOL_HPP
+#define _MEMORY_POOL_HPP
+
+#include <cstddef>
+
+// every block handed out by the allocators below starts on a cache line
+static const std::size_t MEMORY_ALIGNMENT = 64;
+
+void* AlignedAlloc(std::size_t bytes);
+void AlignedFree(void* ptr);
+
+
+// Allocation policies for Array.
+// An allocator is stateless and gets the size of a block back on deallocation.
+
+class HeapAllocator
+{
+public:
+	static void* allocate(std::size_t bytes);
+	static void deallocate(void* ptr, std::size_t bytes);
+};
+
+// Keeps freed blocks in per-thread free lists of power of two size classes
+// (64 bytes up to 64 KiB), so that repeatedly created arrays of similar size
+// do not go to the global heap. Larger blocks are passed to AlignedAlloc.
+// A block may be freed by another thread than the one that allocated it, it then goes
+// into the cache of the freeing thread. Every thread caches at most 4 MiB over all size
+// classes, blocks freed beyond that and the cache of an exiting thread go back to the heap.
+class PoolAllocator
+{
+public:
+	static const std::size_t min_block_size = 64;
+	static const std::size_t max_block_size = 64 * 1024;
+
+	static void* allocate(std::size_t bytes);
+	static void deallocate(void* ptr, std::size_t bytes);
+};
+
+
+#endif
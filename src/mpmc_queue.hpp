@@ -0,0 +1,164 @@
+#pragma once
+#ifndef _MPMC_QUEUE_HPP
+#define _MPMC_QUEUE_HPP
+
+#include <atomic>
+#include <memory>
+#include <cassert>
+#include <utility>
+
+
+// Bounded lock-free multi producer/multi consumer queue (after Dmitry Vyukov).
+// Every cell carries a sequence number which tells producers and consumers
+// in which lap the cell is free or filled, so positions are claimed with a single CAS.
+template<typename T>
+class MPMCQueue
+{
+public:
+	typedef T value_type;
+
+public:
+	MPMCQueue(std::size_t capacity)
+		: mMask(capacity - 1)
+		, mCells(new Cell[capacity])
+		, mEnqueuePos(0)
+		, mDequeuePos(0)
+	{
+		assert(capacity > 1 && (capacity & mMask) == 0);
+		for(std::size_t idx = 0; idx < capacity; ++idx)
+			mCells[idx].sequence.store(idx, std::memory_order_relaxed);
+	}
+
+	~MPMCQueue()
+	{
+	}
+
+	std::size_t capacity() const
+	{
+		return mMask + 1;
+	}
+
+	// returns false if the queue is full, item is untouched then
+	bool try_push(value_type&& item)
+	{
+		std::size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+		Cell* cell;
+		for(;;)
+		{
+			cell = &mCells[pos & mMask];
+			const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+			const std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos);
+			if(diff == 0)
+			{
+				if(mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}else if(diff < 0){
+				return false;
+			}else{
+				pos = mEnqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->data = std::move(item);
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Claims count consecutive cells with one CAS and fills them with value_type(*first++).
+	// Fails without side effects if fewer than count cells are free.
+	template<class Iter>
+	bool try_push_range(Iter first, std::size_t count)
+	{
+		if(count == 0)
+			return true;
+		if(count > capacity())
+			return false;
+
+		std::size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+		for(;;)
+		{
+			bool stale = false;
+			for(std::size_t idx = 0; idx < count; ++idx)
+			{
+				const std::size_t seq = mCells[(pos + idx) & mMask].sequence.load(std::memory_order_acquire);
+				const std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos + idx);
+				if(diff < 0)
+					return false;
+				if(diff > 0)
+				{
+					stale = true;
+					break;
+				}
+			}
+
+			if(stale)
+			{
+				pos = mEnqueuePos.load(std::memory_order_relaxed);
+			}else if(mEnqueuePos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)){
+				break;
+			}
+		}
+
+		for(std::size_t idx = 0; idx < count; ++idx, ++first)
+		{
+			Cell& cell = mCells[(pos + idx) & mMask];
+			cell.data = value_type(*first);
+			cell.sequence.store(pos + idx + 1, std::memory_order_release);
+		}
+		return true;
+	}
+
+	// returns false if the queue is empty
+	bool try_pop(value_type& item)
+	{
+		std::size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+		Cell* cell;
+		for(;;)
+		{
+			cell = &mCells[pos & mMask];
+			const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+			const std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos + 1);
+			if(diff == 0)
+			{
+				if(mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}else if(diff < 0){
+				return false;
+			}else{
+				pos = mDequeuePos.load(std::memory_order_relaxed);
+			}
+		}
+
+		item = std::move(cell->data);
+		cell->sequence.store(pos + mMask + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	MPMCQueue(const MPMCQueue&);
+	MPMCQueue& operator =(const MPMCQueue&);
+
+	struct Cell
+	{
+		std::atomic<std::size_t> sequence;
+		value_type data;
+	};
+
+	// keeps producers and consumers off each others cache line
+	struct Padding
+	{
+		char bytes[64];
+	};
+
+private:
+	const std::size_t mMask;
+	std::unique_ptr<Cell[]> mCells;
+	Padding mPad0;
+	std::atomic<std::size_t> mEnqueuePos;
+	Padding mPad1;
+	std::atomic<std::size_t> mDequeuePos;
+	Padding mPad2;
+};
+
+
+#endif
@@ -0,0 +1,122 @@
+#pragma once
+#ifndef _PHILOX_HPP
+#define _PHILOX_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+
+// Counter based random engine Philox4x32-10
+// (Salmon, Moraes, Dror, Shaw: "Parallel Random Numbers: As Easy as 1, 2, 3").
+// Every (key, stream) pair is an independent sequence, so work items can get their own
+// generator from their index instead of sharing one, and the results do not depend on
+// which thread runs which item. Satisfies the UniformRandomBitGenerator requirements.
+class Philox4x32
+{
+public:
+	typedef std::uint32_t result_type;
+
+public:
+	Philox4x32(std::uint64_t key, std::uint64_t stream = 0)
+		: mIndex(BLOCK_SIZE)
+	{
+		mKey[0] = std::uint32_t(key);
+		mKey[1] = std::uint32_t(key >> 32);
+		mCounter[0] = 0;
+		mCounter[1] = 0;
+		mCounter[2] = std::uint32_t(stream);
+		mCounter[3] = std::uint32_t(stream >> 32);
+	}
+
+	static constexpr result_type min()
+	{
+		return 0;
+	}
+
+	static constexpr result_type max()
+	{
+		return 0xffffffff;
+	}
+
+	result_type operator ()()
+	{
+		if(mIndex == BLOCK_SIZE)
+			_next_block();
+		return mBlock[mIndex++];
+	}
+
+	void discard(unsigned long long count)
+	{
+		while(count--)
+			(*this)();
+	}
+
+	// stream of one work item, e.g. the child of a generation
+	static std::uint64_t stream(std::uint32_t major, std::uint32_t minor)
+	{
+		return (std::uint64_t(major) << 32) | minor;
+	}
+
+	static const unsigned BLOCK_SIZE = 4;
+
+	// Philox4x32-10 for Lanes counters with the same key, written as structure of arrays
+	// so the compiler can vectorize it. Lane i gives the same block as Philox4x32 with the counter ctr[.][i].
+	template<std::size_t Lanes>
+	static void blocks(std::uint32_t key0, std::uint32_t key1, std::uint32_t (&ctr)[BLOCK_SIZE][Lanes])
+	{
+		for(unsigned round = 0; round < ROUNDS; ++round)
+		{
+			for(std::size_t lane = 0; lane < Lanes; ++lane)
+			{
+				const std::uint64_t product0 = std::uint64_t(MULTIPLIER_0) * ctr[0][lane];
+				const std::uint64_t product1 = std::uint64_t(MULTIPLIER_1) * ctr[2][lane];
+
+				const std::uint32_t next0 = std::uint32_t(product1 >> 32) ^ ctr[1][lane] ^ key0;
+				const std::uint32_t next2 = std::uint32_t(product0 >> 32) ^ ctr[3][lane] ^ key1;
+				ctr[0][lane] = next0;
+				ctr[1][lane] = std::uint32_t(product1);
+				ctr[2][lane] = next2;
+				ctr[3][lane] = std::uint32_t(product0);
+			}
+
+			key0 += WEYL_0;
+			key1 += WEYL_1;
+		}
+	}
+
+	// uniform float in [0, 1) from the upper 24 bit
+	static float to_unit_float(std::uint32_t bits)
+	{
+		return float(bits >> 8) * (1.0f / 16777216.0f);
+	}
+
+private:
+	static const unsigned ROUNDS = 10;
+	static const std::uint32_t MULTIPLIER_0 = 0xD2511F53;
+	static const std::uint32_t MULTIPLIER_1 = 0xCD9E8D57;
+	static const std::uint32_t WEYL_0 = 0x9E3779B9;
+	static const std::uint32_t WEYL_1 = 0xBB67AE85;
+
+	void _next_block()
+	{
+		std::uint32_t ctr[BLOCK_SIZE][1] = {{mCounter[0]}, {mCounter[1]}, {mCounter[2]}, {mCounter[3]}};
+		blocks(mKey[0], mKey[1], ctr);
+
+		for(unsigned idx = 0; idx < BLOCK_SIZE; ++idx)
+			mBlock[idx] = ctr[idx][0];
+		mIndex = 0;
+
+		// the lower 64 bit of the counter count the blocks of the stream
+		if(++mCounter[0] == 0)
+			++mCounter[1];
+	}
+
+private:
+	std::uint32_t mKey[2];
+	std::uint32_t mCounter[BLOCK_SIZE];
+	std::uint32_t mBlock[BLOCK_SIZE];
+	unsigned mIndex;
+};
+
+
+#endif
@@ -0,0 +1,174 @@
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+#include "range_extrema.hpp"
+
+
+namespace {
+
+struct PickMin
+{
+	float operator ()(float a, float b) const
+	{
+		return std::min(a, b);
+	}
+};
+
+struct PickMax
+{
+	float operator ()(float a, float b) const
+	{
+		return std::max(a, b);
+	}
+};
+
+std::size_t FloorLog2( std::uint64_t value )
+{
+	assert(value > 0);
+	std::size_t result = 0;
+	for(std::size_t shift = 32; shift > 0; shift /= 2)
+	{
+		if(value >> shift)
+		{
+			value >>= shift;
+			result += shift;
+		}
+	}
+	return result;
+}
+
+}
+
+
+RangeExtrema::RangeExtrema()
+	: mValues(nullptr)
+	, mCount(0)
+	, mBlockCount(0)
+{
+}
+
+RangeExtrema::~RangeExtrema()
+{
+}
+
+void RangeExtrema::build( const float* values, std::size_t count )
+{
+	mValues = values;
+	mCount = count;
+	mBlockCount = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+	mBlockPrefixMin.resize(count);
+	mBlockPrefixMax.resize(count);
+	mBlockSuffixMin.resize(count);
+	mBlockSuffixMax.resize(count);
+
+	const std::size_t level_count = mBlockCount? FloorLog2(mBlockCount) + 1 : 0;
+	mTableMin.resize(level_count * mBlockCount);
+	mTableMax.resize(level_count * mBlockCount);
+
+	for(std::size_t block = 0; block < mBlockCount; ++block)
+	{
+		const std::size_t begin = block * BLOCK_SIZE;
+		const std::size_t end = std::min(begin + BLOCK_SIZE, count);
+
+		mBlockPrefixMin[begin] = mBlockPrefixMax[begin] = values[begin];
+		for(std::size_t idx = begin + 1; idx < end; ++idx)
+		{
+			mBlockPrefixMin[idx] = std::min(mBlockPrefixMin[idx - 1], values[idx]);
+			mBlockPrefixMax[idx] = std::max(mBlockPrefixMax[idx - 1], values[idx]);
+		}
+
+		mBlockSuffixMin[end - 1] = mBlockSuffixMax[end - 1] = values[end - 1];
+		for(std::size_t idx = end - 1; idx > begin; --idx)
+		{
+			mBlockSuffixMin[idx - 1] = std::min(mBlockSuffixMin[idx], values[idx - 1]);
+			mBlockSuffixMax[idx - 1] = std::max(mBlockSuffixMax[idx], values[idx - 1]);
+		}
+
+		mTableMin[block] = mBlockPrefixMin[end - 1];
+		mTableMax[block] = mBlockPrefixMax[end - 1];
+	}
+
+	for(std::size_t level = 1; level < level_count; ++level)
+	{
+		const std::size_t half = std::size_t(1) << (level - 1);
+		float* min_row = mTableMin.data() + level * mBlockCount;
+		float* max_row = mTableMax.data() + level * mBlockCount;
+		const float* prev_min_row = min_row - mBlockCount;
+		const float* prev_max_row = max_row - mBlockCount;
+
+		for(std::size_t block = 0; block + 2 * half <= mBlockCount; ++block)
+		{
+			min_row[block] = std::min(prev_min_row[block], prev_min_row[block + half]);
+			max_row[block] = std::max(prev_max_row[block], prev_max_row[block + half]);
+		}
+	}
+}
+
+std::size_t RangeExtrema::size() const
+{
+	return mCount;
+}
+
+float RangeExtrema::range_min( std::size_t first, std::size_t last ) const
+{
+	return _query(first, last, mBlockPrefixMin, mBlockSuffixMin, mTableMin, PickMin());
+}
+
+float RangeExtrema::range_max( std::size_t first, std::size_t last ) const
+{
+	return _query(first, last, mBlockPrefixMax, mBlockSuffixMax, mTableMax, PickMax());
+}
+
+float RangeExtrema::prefix_min( std::size_t tick ) const
+{
+	return range_min(0, tick + 1);
+}
+
+float RangeExtrema::prefix_max( std::size_t tick ) const
+{
+	return range_max(0, tick + 1);
+}
+
+float RangeExtrema::suffix_min( std::size_t tick ) const
+{
+	return range_min(tick, mCount);
+}
+
+float RangeExtrema::suffix_max( std::size_t tick ) const
+{
+	return range_max(tick, mCount);
+}
+
+template<typename Pick>
+float RangeExtrema::_query( std::size_t first, std::size_t last, const std::vector<float>& block_prefix, const std::vector<float>& block_suffix,
+							const std::vector<float>& table, Pick pick ) const
+{
+	assert(first < last && last <= mCount);
+	const std::size_t first_block = first / BLOCK_SIZE;
+	const std::size_t last_block = (last - 1) / BLOCK_SIZE;
+
+	if(first_block == last_block)
+	{
+		if(first % BLOCK_SIZE == 0)
+			return block_prefix[last - 1];
+		if(last % BLOCK_SIZE == 0 || last == mCount)
+			return block_suffix[first];
+
+		float result = mValues[first];
+		for(std::size_t idx = first + 1; idx < last; ++idx)
+			result = pick(result, mValues[idx]);
+		return result;
+	}
+
+	float result = pick(block_suffix[first], block_prefix[last - 1]);
+	if(last_block - first_block > 1)
+	{
+		const std::size_t begin = first_block + 1;
+		const std::size_t block_count = last_block - begin;
+		const std::size_t level = FloorLog2(block_count);
+		const float* row = table.data() + level * mBlockCount;
+		result = pick(result, pick(row[begin], row[last_block - (std::size_t(1) << level)]));
+	}
+	return result;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#ifndef _RANGE_EXTREMA_HPP
+#define _RANGE_EXTREMA_HPP
+
+#include <cstddef>
+#include <vector>
+
+
+// O(1) minimum and maximum of any range of a fixed series.
+// The series is split into blocks of BLOCK_SIZE values. Every value knows the extrema from
+// the start of its block and up to the end of its block, and a sparse table answers the
+// queries over whole blocks. A range is covered by the tail of its first block, whole blocks
+// and the head of its last block, so it needs O(n) memory instead of O(n log n).
+// Only ranges inside one block that touch neither block border are scanned (< BLOCK_SIZE values).
+class RangeExtrema
+{
+public:
+	static const std::size_t BLOCK_SIZE = 32;
+
+public:
+	RangeExtrema();
+	~RangeExtrema();
+
+	// the values have to outlive the table and must not change
+	void build(const float* values, std::size_t count);
+
+	std::size_t size() const;
+
+	// extrema of [first, last), the range must not be empty
+	float range_min(std::size_t first, std::size_t last) const;
+	float range_max(std::size_t first, std::size_t last) const;
+
+	// extrema of [0, tick] and [tick, size)
+	float prefix_min(std::size_t tick) const;
+	float prefix_max(std::size_t tick) const;
+	float suffix_min(std::size_t tick) const;
+	float suffix_max(std::size_t tick) const;
+
+private:
+	template<typename Pick>
+	float _query(std::size_t first, std::size_t last, const std::vector<float>& block_prefix, const std::vector<float>& block_suffix,
+				 const std::vector<float>& table, Pick pick) const;
+
+private:
+	const float* mValues;
+	std::size_t mCount;
+	std::size_t mBlockCount;
+	// extrema from the start of the block to the value and from the value to the end of the block
+	std::vector<float> mBlockPrefixMin;
+	std::vector<float> mBlockPrefixMax;
+	std::vector<float> mBlockSuffixMin;
+	std::vector<float> mBlockSuffixMax;
+	// level l, block b: extrema of the blocks [b, b + 2^l)
+	std::vector<float> mTableMin;
+	std::vector<float> mTableMax;
+};
+
+
+#endif
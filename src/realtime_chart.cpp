@@ -4,8 +4,9 @@
 
 
 
-WalkingChart::WalkingChart( ChartModel* back_model)
+WalkingChart::WalkingChart( const ChartModel* back_model)
 	: mBackModel(back_model)
+	, mValues(back_model->values())
 {
 	assert(mBackModel);
 	assert(mBackModel->tick_count() > 0);
@@ -18,7 +19,7 @@ WalkingChart::~WalkingChart()
 
 float WalkingChart::current_value() const
 {
-	return mBackModel->value(data_count() - 1);
+	return mValues[data_count() - 1];
 }
 
 std::size_t WalkingChart::data_count() const
@@ -28,7 +29,12 @@ std::size_t WalkingChart::data_count() const
 
 float WalkingChart::tick_value( std::size_t tick ) const
 {
-	return mBackModel->value(std::min(tick, data_count() - 1));
+	return mValues[std::min(tick, data_count() - 1)];
+}
+
+const float* WalkingChart::values() const
+{
+	return mValues;
 }
 
 
@@ -53,7 +59,7 @@ float WalkingChart::max_value() const
 }
 
 
-RealtimeChart::RealtimeChart( ChartModel* back_model, float ticks_per_second )
+RealtimeChart::RealtimeChart( const ChartModel* back_model, float ticks_per_second )
 	: WalkingChart(back_model)
 	, mTicksPerSecond(ticks_per_second)
 	, mCurrentTime(0)
@@ -100,9 +106,9 @@ float RealtimeChart::ticks_per_second() const
 
 
 
-TickChart::TickChart( ChartModel* back_model )
+TickChart::TickChart( const ChartModel* back_model )
 	: WalkingChart(back_model)
-	, mCurrentTick(0)
+	, mCursor(*back_model)
 {
 }
 
@@ -110,13 +116,7 @@ TickChart::~TickChart()
 {
 }
 
-bool TickChart::walk_tick( std::size_t count /*= 1*/ )
-{
-	mCurrentTick += count;
-	return count > 0;
-}
-
 std::size_t TickChart::current_tick() const
 {
-	return mCurrentTick;
+	return mCursor.tick();
 }
@@ -4,12 +4,13 @@
 
 
 #include "chart_model.hpp"
+#include "chart_cursor.hpp"
 
 
 class WalkingChart
 {
 public:
-	WalkingChart(ChartModel* back_model);
+	WalkingChart(const ChartModel* back_model);
 	virtual ~WalkingChart();
 	virtual std::size_t current_tick() const = 0;
 
@@ -19,17 +20,20 @@ public:
 	float current_value() const;
 	std::size_t data_count() const;
 	float tick_value(std::size_t tick) const;
+	// the walked values are the first data_count() ones
+	const float* values() const;
 
 	std::size_t max_ticks() const;
 	bool is_done() const;
 private:
 	const ChartModel* mBackModel;
+	const float* mValues;
 };
 
 class RealtimeChart: public WalkingChart
 {
 public:
-	RealtimeChart(ChartModel* back_model, float ticks_per_second);
+	RealtimeChart(const ChartModel* back_model, float ticks_per_second);
 	~RealtimeChart();
 
 	virtual std::size_t current_tick() const;
@@ -47,14 +51,26 @@ private:
 class TickChart: public WalkingChart
 {
 public:
-	TickChart(ChartModel* back_model);
+	TickChart(const ChartModel* back_model);
 	~TickChart();
 
-	bool walk_tick(std::size_t count = 1);
+	// inline, it is called for every tick of a simulation
+	bool walk_tick(std::size_t count = 1)
+	{
+		mCursor.advance(count);
+		return count > 0;
+	}
+
 	virtual std::size_t current_tick() const;
 
+	// the non-virtual view of the position for the simulation hot path
+	const ChartCursor& cursor() const
+	{
+		return mCursor;
+	}
+
 private:
-	std::size_t mCurrentTick;
+	ChartCursor mCursor;
 };
 
 #endif
\ No newline at end of file
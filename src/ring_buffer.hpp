@@ -0,0 +1,128 @@
+#pragma once
+#ifndef _RING_BUFFER_HPP
+#define _RING_BUFFER_HPP
+
+#include <memory>
+#include <cassert>
+
+
+// Fixed capacity double ended queue in one contiguous block with O(1) random access.
+// The capacity is rounded up to a power of two, so positions wrap with a mask.
+template<typename T>
+class RingBuffer
+{
+public:
+	typedef T value_type;
+
+public:
+	RingBuffer(std::size_t capacity)
+		: mMask(_round_up(capacity) - 1)
+		, mValues(new value_type[mMask + 1])
+		, mFirst(0)
+		, mSize(0)
+	{
+	}
+
+	~RingBuffer()
+	{
+	}
+
+	std::size_t capacity() const
+	{
+		return mMask + 1;
+	}
+
+	std::size_t size() const
+	{
+		return mSize;
+	}
+
+	bool empty() const
+	{
+		return mSize == 0;
+	}
+
+	bool full() const
+	{
+		return mSize > mMask;
+	}
+
+	value_type& operator [](std::size_t idx)
+	{
+		assert(idx < mSize);
+		return mValues[(mFirst + idx) & mMask];
+	}
+
+	const value_type& operator [](std::size_t idx) const
+	{
+		assert(idx < mSize);
+		return mValues[(mFirst + idx) & mMask];
+	}
+
+	// values from idx on up to the end or the wrap of the buffer, *count is set to their number
+	const value_type* run(std::size_t idx, std::size_t* count) const
+	{
+		assert(idx <= mSize);
+		const std::size_t pos = (mFirst + idx) & mMask;
+		const std::size_t to_wrap = capacity() - pos;
+		*count = mSize - idx < to_wrap? mSize - idx : to_wrap;
+		return mValues.get() + pos;
+	}
+
+	const value_type& front() const
+	{
+		return (*this)[0];
+	}
+
+	const value_type& back() const
+	{
+		return (*this)[mSize - 1];
+	}
+
+	void push_back(const value_type& value)
+	{
+		assert(!full());
+		mValues[(mFirst + mSize) & mMask] = value;
+		++mSize;
+	}
+
+	void pop_front()
+	{
+		assert(!empty());
+		mFirst = (mFirst + 1) & mMask;
+		--mSize;
+	}
+
+	void pop_back()
+	{
+		assert(!empty());
+		--mSize;
+	}
+
+	void clear()
+	{
+		mFirst = 0;
+		mSize = 0;
+	}
+
+private:
+	RingBuffer(const RingBuffer&);
+	RingBuffer& operator =(const RingBuffer&);
+
+	static std::size_t _round_up(std::size_t capacity)
+	{
+		std::size_t result = 1;
+		while(result < capacity)
+			result *= 2;
+		return result;
+	}
+
+private:
+	const std::size_t mMask;
+	std::unique_ptr<value_type[]> mValues;
+	std::size_t mFirst;
+	std::size_t mSize;
+};
+
+
+#endif
@@ -0,0 +1,202 @@
+#include <cassert>
+#include <algorithm>
+#include <numeric>
+#include "selection.hpp"
+#include "utils.hpp"
+
+
+std::unique_ptr<Selection> CreateSelection( const SelectionSettings& settings )
+{
+	switch(settings.method)
+	{
+	case SelectionSettings::StochasticUniversal:
+		return std::unique_ptr<Selection>(new StochasticUniversalSelection());
+	case SelectionSettings::Tournament:
+		return std::unique_ptr<Selection>(new TournamentSelection(settings.tournament_size));
+	case SelectionSettings::Rank:
+		return std::unique_ptr<Selection>(new RankSelection(settings.rank_pressure));
+	default:
+		return std::unique_ptr<Selection>(new RouletteSelection());
+	}
+}
+
+/////////////////////////////////////////// AliasTable ///////////////////////////////////////////
+AliasTable::AliasTable()
+{
+}
+
+void AliasTable::build( const float* weights, std::size_t count )
+{
+	assert(count > 0);
+	mProbability.resize(count);
+	mAlias.resize(count);
+
+	double sum = 0.0;
+	for(std::size_t idx = 0; idx < count; ++idx)
+		sum += std::max(0.0f, weights[idx]);
+
+	if(sum <= 0.0)
+	{
+		std::fill(mProbability.begin(), mProbability.end(), 1.0f);
+		for(std::size_t idx = 0; idx < count; ++idx)
+			mAlias[idx] = std::uint32_t(idx);
+		return;
+	}
+
+	// Vose: scale to mean 1, then pair every small column with a large one
+	std::vector<double> scaled(count);
+	std::vector<std::uint32_t> small;
+	std::vector<std::uint32_t> large;
+	for(std::size_t idx = 0; idx < count; ++idx)
+	{
+		scaled[idx] = double(std::max(0.0f, weights[idx])) * double(count) / sum;
+		(scaled[idx] < 1.0? small : large).push_back(std::uint32_t(idx));
+	}
+
+	while(!small.empty() && !large.empty())
+	{
+		const std::uint32_t s = small.back();
+		const std::uint32_t l = large.back();
+		small.pop_back();
+
+		mProbability[s] = float(scaled[s]);
+		mAlias[s] = l;
+
+		scaled[l] -= 1.0 - scaled[s];
+		if(scaled[l] < 1.0)
+		{
+			large.pop_back();
+			small.push_back(l);
+		}
+	}
+
+	// what is left is 1 up to rounding errors
+	for(std::uint32_t idx : small)
+	{
+		mProbability[idx] = 1.0f;
+		mAlias[idx] = idx;
+	}
+	for(std::uint32_t idx : large)
+	{
+		mProbability[idx] = 1.0f;
+		mAlias[idx] = idx;
+	}
+}
+
+std::size_t AliasTable::size() const
+{
+	return mProbability.size();
+}
+
+std::size_t AliasTable::sample( SelectionRandom& rng ) const
+{
+	assert(size() > 0);
+	std::uniform_int_distribution<std::size_t> column_distribution(0, size() - 1);
+	std::uniform_real_distribution<float> coin_distribution(0.0f, 1.0f);
+
+	const std::size_t column = column_distribution(rng);
+	return coin_distribution(rng) < mProbability[column]? column : mAlias[column];
+}
+
+/////////////////////////////////////////// RouletteSelection ///////////////////////////////////////////
+void RouletteSelection::prepare( const float* fitness, std::size_t count, std::size_t, SelectionRandom& )
+{
+	mTable.build(fitness, count);
+}
+
+std::size_t RouletteSelection::select( std::size_t, SelectionRandom& rng ) const
+{
+	return mTable.sample(rng);
+}
+
+/////////////////////////////////////////// StochasticUniversalSelection ///////////////////////////////////////////
+void StochasticUniversalSelection::prepare( const float* fitness, std::size_t count, std::size_t pick_count, SelectionRandom& rng )
+{
+	assert(count > 0 && pick_count > 0);
+	mPrefixSum.resize(count + 1);
+	mPrefixSum[0] = 0.0;
+	for(std::size_t idx = 0; idx < count; ++idx)
+		mPrefixSum[idx + 1] = mPrefixSum[idx] + double(std::max(0.0f, fitness[idx]));
+
+	mPicks.resize(pick_count);
+	const double total = mPrefixSum.back();
+	if(total <= 0.0)
+	{
+		for(std::size_t slot = 0; slot < pick_count; ++slot)
+			mPicks[slot] = std::uint32_t(slot * count / pick_count);
+	}else{
+		// the pointers are increasing, so one walk over the prefix sums finds all of them
+		const double step = total / double(pick_count);
+		const double start = std::uniform_real_distribution<double>(0.0, step)(rng);
+		std::size_t idx = 0;
+		for(std::size_t slot = 0; slot < pick_count; ++slot)
+		{
+			const double pointer = start + double(slot) * step;
+			while(idx + 1 < count && mPrefixSum[idx + 1] <= pointer)
+				++idx;
+			mPicks[slot] = std::uint32_t(idx);
+		}
+	}
+
+	std::shuffle(mPicks.begin(), mPicks.end(), rng);
+}
+
+std::size_t StochasticUniversalSelection::select( std::size_t slot, SelectionRandom& ) const
+{
+	assert(!mPicks.empty());
+	return mPicks[slot % mPicks.size()];
+}
+
+/////////////////////////////////////////// TournamentSelection ///////////////////////////////////////////
+TournamentSelection::TournamentSelection( std::size_t tournament_size )
+	: mTournamentSize(std::max<std::size_t>(1, tournament_size))
+{
+}
+
+void TournamentSelection::prepare( const float* fitness, std::size_t count, std::size_t, SelectionRandom& )
+{
+	mFitness.assign(fitness, fitness + count);
+}
+
+std::size_t TournamentSelection::select( std::size_t, SelectionRandom& rng ) const
+{
+	assert(!mFitness.empty());
+	std::uniform_int_distribution<std::size_t> distribution(0, mFitness.size() - 1);
+
+	std::size_t best = distribution(rng);
+	for(std::size_t round = 1; round < mTournamentSize; ++round)
+	{
+		const std::size_t other = distribution(rng);
+		if(mFitness[other] > mFitness[best])
+			best = other;
+	}
+	return best;
+}
+
+/////////////////////////////////////////// RankSelection ///////////////////////////////////////////
+RankSelection::RankSelection( float pressure )
+	: mPressure(between(1.0f, pressure, 2.0f))
+{
+}
+
+void RankSelection::prepare( const float* fitness, std::size_t count, std::size_t, SelectionRandom& )
+{
+	assert(count > 0);
+	mByRank.resize(count);
+	std::iota(mByRank.begin(), mByRank.end(), 0);
+	std::stable_sort(mByRank.begin(), mByRank.end(), [fitness](std::uint32_t a, std::uint32_t b) { return fitness[a] < fitness[b]; });
+
+	// rank 0 is the worst, the weights go linearly from 2 - pressure to pressure
+	std::vector<float> weights(count, 1.0f);
+	if(count > 1)
+	{
+		for(std::size_t rank = 0; rank < count; ++rank)
+			weights[rank] = (2.0f - mPressure) + 2.0f * (mPressure - 1.0f) * float(rank) / float(count - 1);
+	}
+	mTable.build(weights.data(), count);
+}
+
+std::size_t RankSelection::select( std::size_t, SelectionRandom& rng ) const
+{
+	return mByRank[mTable.sample(rng)];
+}
@@ -0,0 +1,133 @@
+#pragma once
+#ifndef _SELECTION_HPP
+#define _SELECTION_HPP
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <random>
+#include "philox.hpp"
+
+
+typedef Philox4x32 SelectionRandom;
+
+
+struct SelectionSettings
+{
+	enum Method
+	{
+		Roulette,
+		StochasticUniversal,
+		Tournament,
+		Rank
+	};
+
+	SelectionSettings()
+		: method(Roulette)
+		, tournament_size(3)
+		, rank_pressure(1.5f)
+	{
+	}
+
+	Method method;
+	std::size_t tournament_size;
+	// expected picks of the best entity under linear ranking, in [1, 2]
+	float rank_pressure;
+};
+
+
+// Walker's alias table: draws index i with probability weights[i] / sum(weights) in O(1).
+// If all weights are zero every index is equally likely.
+class AliasTable
+{
+public:
+	AliasTable();
+
+	// O(n), negative weights count as zero
+	void build(const float* weights, std::size_t count);
+
+	std::size_t size() const;
+	std::size_t sample(SelectionRandom& rng) const;
+
+private:
+	std::vector<float> mProbability;
+	std::vector<std::uint32_t> mAlias;
+};
+
+
+// Picks the parents of a new generation.
+// prepare() is called once per generation and builds whatever tables the method needs,
+// afterwards select() only reads them, so the picks can be drawn from several threads.
+class Selection
+{
+public:
+	virtual ~Selection() {}
+
+	// pick_count is the number of select() slots that will be used
+	virtual void prepare(const float* fitness, std::size_t count, std::size_t pick_count, SelectionRandom& rng) = 0;
+
+	// index of the entity picked for the slot
+	virtual std::size_t select(std::size_t slot, SelectionRandom& rng) const = 0;
+};
+
+std::unique_ptr<Selection> CreateSelection(const SelectionSettings& settings);
+
+
+// fitness proportional, O(1) per pick
+class RouletteSelection: public Selection
+{
+public:
+	virtual void prepare(const float* fitness, std::size_t count, std::size_t pick_count, SelectionRandom& rng);
+	virtual std::size_t select(std::size_t slot, SelectionRandom& rng) const;
+
+private:
+	AliasTable mTable;
+};
+
+
+// fitness proportional with minimal spread: all picks come from one spin with pick_count
+// equally spaced pointers (Baker), shuffled so that the slots are not ordered
+class StochasticUniversalSelection: public Selection
+{
+public:
+	virtual void prepare(const float* fitness, std::size_t count, std::size_t pick_count, SelectionRandom& rng);
+	virtual std::size_t select(std::size_t slot, SelectionRandom& rng) const;
+
+private:
+	std::vector<double> mPrefixSum;
+	std::vector<std::uint32_t> mPicks;
+};
+
+
+// best of tournament_size uniformly drawn entities, O(tournament_size) per pick
+class TournamentSelection: public Selection
+{
+public:
+	TournamentSelection(std::size_t tournament_size);
+
+	virtual void prepare(const float* fitness, std::size_t count, std::size_t pick_count, SelectionRandom& rng);
+	virtual std::size_t select(std::size_t slot, SelectionRandom& rng) const;
+
+private:
+	const std::size_t mTournamentSize;
+	std::vector<float> mFitness;
+};
+
+
+// linear ranking, only the order of the fitness values matters, O(1) per pick
+class RankSelection: public Selection
+{
+public:
+	RankSelection(float pressure);
+
+	virtual void prepare(const float* fitness, std::size_t count, std::size_t pick_count, SelectionRandom& rng);
+	virtual std::size_t select(std::size_t slot, SelectionRandom& rng) const;
+
+private:
+	const float mPressure;
+	std::vector<std::uint32_t> mByRank;
+	AliasTable mTable;
+};
+
+
+#endif
@@ -0,0 +1,111 @@
+#pragma once
+#ifndef _SLIDING_SERIES_HPP
+#define _SLIDING_SERIES_HPP
+
+#include <cassert>
+#include "ring_buffer.hpp"
+
+
+// The last window_size values of an endless series, with O(1) access to every value and to
+// the extrema of the window. The extrema are kept in monotonic queues of running indices
+// (the candidates that are not dominated by a later value), so push() is amortized O(1).
+class SlidingSeries
+{
+public:
+	SlidingSeries(std::size_t window_size)
+		: mWindowSize(window_size)
+		, mFirstIndex(0)
+		, mValues(window_size)
+		, mMinQueue(window_size)
+		, mMaxQueue(window_size)
+	{
+		assert(window_size > 0);
+	}
+
+	std::size_t window_size() const
+	{
+		return mWindowSize;
+	}
+
+	std::size_t size() const
+	{
+		return mValues.size();
+	}
+
+	bool empty() const
+	{
+		return mValues.empty();
+	}
+
+	// running index of value(0), counts the values that left the window
+	std::size_t first_index() const
+	{
+		return mFirstIndex;
+	}
+
+	float value(std::size_t idx) const
+	{
+		return mValues[idx];
+	}
+
+	// contiguous values from idx on, *count is set to their number
+	const float* values(std::size_t idx, std::size_t* count) const
+	{
+		return mValues.run(idx, count);
+	}
+
+	// the series must not be empty
+	float min_value() const
+	{
+		return _at(mMinQueue.front());
+	}
+
+	float max_value() const
+	{
+		return _at(mMaxQueue.front());
+	}
+
+	void push(float value)
+	{
+		if(mValues.size() == mWindowSize)
+		{
+			if(mMinQueue.front() == mFirstIndex)
+				mMinQueue.pop_front();
+			if(mMaxQueue.front() == mFirstIndex)
+				mMaxQueue.pop_front();
+			mValues.pop_front();
+			++mFirstIndex;
+		}
+
+		const std::size_t index = mFirstIndex + mValues.size();
+		mValues.push_back(value);
+
+		while(!mMinQueue.empty() && _at(mMinQueue.back()) >= value)
+			mMinQueue.pop_back();
+		mMinQueue.push_back(index);
+
+		while(!mMaxQueue.empty() && _at(mMaxQueue.back()) <= value)
+			mMaxQueue.pop_back();
+		mMaxQueue.push_back(index);
+	}
+
+private:
+	SlidingSeries(const SlidingSeries&);
+	SlidingSeries& operator =(const SlidingSeries&);
+
+	float _at(std::size_t index) const
+	{
+		return mValues[index - mFirstIndex];
+	}
+
+private:
+	const std::size_t mWindowSize;
+	std::size_t mFirstIndex;
+	RingBuffer<float> mValues;
+	// running indices with increasing values (min) or decreasing values (max)
+	RingBuffer<std::size_t> mMinQueue;
+	RingBuffer<std::size_t> mMaxQueue;
+};
+
+
+#endif
@@ -0,0 +1,116 @@
+#pragma once
+#ifndef _SPSC_RING_HPP
+#define _SPSC_RING_HPP
+
+#include <atomic>
+#include <memory>
+#include <cassert>
+#include <utility>
+
+
+// Bounded lock-free ring buffer for exactly one producer and one consumer thread.
+// Each side owns one index and only reads the other one, so neither side ever waits
+// or retries. Both keep a cached copy of the other index and reload it only when the
+// ring looks full or empty, which keeps the shared cache lines quiet.
+template<typename T>
+class SPSCRing
+{
+public:
+	typedef T value_type;
+
+public:
+	SPSCRing(std::size_t capacity)
+		: mMask(capacity - 1)
+		, mCells(new value_type[capacity])
+		, mHead(0)
+		, mCachedTail(0)
+		, mTail(0)
+		, mCachedHead(0)
+	{
+		assert(capacity > 1 && (capacity & mMask) == 0);
+	}
+
+	~SPSCRing()
+	{
+	}
+
+	std::size_t capacity() const
+	{
+		return mMask + 1;
+	}
+
+	// producer only, returns false if the ring is full
+	bool try_push(const value_type& item)
+	{
+		const std::size_t head = mHead.load(std::memory_order_relaxed);
+		if(head - mCachedTail > mMask)
+		{
+			mCachedTail = mTail.load(std::memory_order_acquire);
+			if(head - mCachedTail > mMask)
+				return false;
+		}
+
+		mCells[head & mMask] = item;
+		mHead.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer only, returns false if the ring is empty
+	bool try_pop(value_type& item)
+	{
+		const std::size_t tail = mTail.load(std::memory_order_relaxed);
+		if(tail == mCachedHead)
+		{
+			mCachedHead = mHead.load(std::memory_order_acquire);
+			if(tail == mCachedHead)
+				return false;
+		}
+
+		item = std::move(mCells[tail & mMask]);
+		mTail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer only, passes everything pushed so far to func(const value_type&) and
+	// releases the cells in one store, returns the number of items
+	template<typename Func>
+	std::size_t drain(Func func)
+	{
+		const std::size_t tail = mTail.load(std::memory_order_relaxed);
+		mCachedHead = mHead.load(std::memory_order_acquire);
+		if(tail == mCachedHead)
+			return 0;
+
+		for(std::size_t pos = tail; pos != mCachedHead; ++pos)
+			func(const_cast<const value_type&>(mCells[pos & mMask]));
+
+		mTail.store(mCachedHead, std::memory_order_release);
+		return mCachedHead - tail;
+	}
+
+private:
+	SPSCRing(const SPSCRing&);
+	SPSCRing& operator =(const SPSCRing&);
+
+	// keeps the producer and the consumer off each others cache line
+	struct Padding
+	{
+		char bytes[64];
+	};
+
+private:
+	const std::size_t mMask;
+	std::unique_ptr<value_type[]> mCells;
+	Padding mPad0;
+	// written by the producer
+	std::atomic<std::size_t> mHead;
+	std::size_t mCachedTail;
+	Padding mPad1;
+	// written by the consumer
+	std::atomic<std::size_t> mTail;
+	std::size_t mCachedHead;
+	Padding mPad2;
+};
+
+
+#endif
@@ -0,0 +1,176 @@
+#pragma once
+#ifndef _TASK_HPP
+#define _TASK_HPP
+
+#include <new>
+#include <utility>
+#include <cassert>
+#include <type_traits>
+
+
+// Move only replacement for std::function<void()>.
+// Callables up to inline_size bytes are stored inside the task, so posting the usual
+// lambdas with a few captured pointers does not allocate. Bigger ones go to the heap.
+class Task
+{
+public:
+	static const std::size_t inline_size = 56;
+	static const std::size_t inline_align = alignof(void*);
+
+public:
+	Task()
+		: mOps(nullptr)
+	{
+	}
+
+	template<class Func, class = typename std::enable_if<!std::is_same<typename std::decay<Func>::type, Task>::value>::type>
+	Task(Func&& func)
+		: mOps(nullptr)
+	{
+		typedef typename std::decay<Func>::type func_type;
+		typedef typename std::conditional<_fits_inline<func_type>::value, InlineOps<func_type>, HeapOps<func_type>>::type ops_type;
+
+		ops_type::construct(&mStorage, std::forward<Func>(func));
+		mOps = &ops_type::Table;
+	}
+
+	Task(Task&& other)
+		: mOps(other.mOps)
+	{
+		if(mOps)
+		{
+			mOps->move(&mStorage, &other.mStorage);
+			other.mOps = nullptr;
+		}
+	}
+
+	~Task()
+	{
+		reset();
+	}
+
+	Task& operator =(Task&& other)
+	{
+		if(this != &other)
+		{
+			reset();
+			if(other.mOps)
+			{
+				mOps = other.mOps;
+				mOps->move(&mStorage, &other.mStorage);
+				other.mOps = nullptr;
+			}
+		}
+		return *this;
+	}
+
+	void operator ()()
+	{
+		assert(mOps);
+		mOps->invoke(&mStorage);
+	}
+
+	explicit operator bool() const
+	{
+		return mOps != nullptr;
+	}
+
+	void reset()
+	{
+		if(mOps)
+		{
+			mOps->destroy(&mStorage);
+			mOps = nullptr;
+		}
+	}
+
+private:
+	Task(const Task&);
+	Task& operator =(const Task&);
+
+	typedef std::aligned_storage<inline_size, inline_align>::type storage_type;
+
+	struct Ops
+	{
+		void (*invoke)(void* storage);
+		// move constructs into dst and destroys src
+		void (*move)(void* dst, void* src);
+		void (*destroy)(void* storage);
+	};
+
+	template<class Func>
+	struct _fits_inline
+	{
+		static const bool value = sizeof(Func) <= inline_size
+								&& inline_align % alignof(Func) == 0
+								&& std::is_nothrow_move_constructible<Func>::value;
+	};
+
+	template<class Func>
+	struct InlineOps
+	{
+		template<class F>
+		static void construct(void* storage, F&& func)
+		{
+			new (storage) Func(std::forward<F>(func));
+		}
+
+		static void invoke(void* storage)
+		{
+			(*static_cast<Func*>(storage))();
+		}
+
+		static void move(void* dst, void* src)
+		{
+			new (dst) Func(std::move(*static_cast<Func*>(src)));
+			static_cast<Func*>(src)->~Func();
+		}
+
+		static void destroy(void* storage)
+		{
+			static_cast<Func*>(storage)->~Func();
+		}
+
+		static const Ops Table;
+	};
+
+	template<class Func>
+	struct HeapOps
+	{
+		template<class F>
+		static void construct(void* storage, F&& func)
+		{
+			*static_cast<Func**>(storage) = new Func(std::forward<F>(func));
+		}
+
+		static void invoke(void* storage)
+		{
+			(**static_cast<Func**>(storage))();
+		}
+
+		static void move(void* dst, void* src)
+		{
+			*static_cast<Func**>(dst) = *static_cast<Func**>(src);
+		}
+
+		static void destroy(void* storage)
+		{
+			delete *static_cast<Func**>(storage);
+		}
+
+		static const Ops Table;
+	};
+
+private:
+	storage_type mStorage;
+	const Ops* mOps;
+};
+
+template<class Func>
+const Task::Ops Task::InlineOps<Func>::Table = { &InlineOps<Func>::invoke, &InlineOps<Func>::move, &InlineOps<Func>::destroy };
+
+template<class Func>
+const Task::Ops Task::HeapOps<Func>::Table = { &HeapOps<Func>::invoke, &HeapOps<Func>::move, &HeapOps<Func>::destroy };
+
+
+#endif
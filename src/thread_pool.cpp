@@ -1,32 +1,92 @@
 #include <cassert>
 #include "thread_pool.hpp"
+#include "memory_pool.hpp"
 
 
+static const std::size_t WORKER_DEQUE_CAPACITY = 4096;
+static const std::size_t INJECT_QUEUE_CAPACITY = 8192;
+static const std::size_t IDLE_SPIN_COUNT = 64;
+
+// the pool and deque index of the current thread, if it is a worker
+static thread_local ThreadPool* GCurrentPool = nullptr;
+static thread_local std::size_t GCurrentWorker = 0;
+
+
+// Tasks in the worker deques are referenced by pointer. The nodes come from the
+// per-thread PoolAllocator, so in steady state pushing and popping does not hit the heap.
+static ThreadPool::task_func* NewTaskNode(ThreadPool::task_func&& task)
+{
+	void* mem = PoolAllocator::allocate(sizeof(ThreadPool::task_func));
+	return new (mem) ThreadPool::task_func(std::move(task));
+}
+
+static void DeleteTaskNode(ThreadPool::task_func* node)
+{
+	node->~Task();
+	PoolAllocator::deallocate(node, sizeof(ThreadPool::task_func));
+}
+
 
 ThreadPool::ThreadPool( std::size_t _pool_size )
-	: mRunning(true)
+	: mInjectedTasks(INJECT_QUEUE_CAPACITY)
+	, mSleepingWorkers(0)
+	, mQueuedTasks(0)
+	, mRunning(true)
 	, mCurrentTasks(0)
 {
-	while(_pool_size--)
+	if(_pool_size == 0)
+		_pool_size = default_size();
+
+	for(std::size_t idx = 0; idx < _pool_size; ++idx)
 	{
-		mWorkers.push_back(std::thread(std::bind(&ThreadPool::_worker_func, this)));
+		mDeques.emplace_back(new deque_type(WORKER_DEQUE_CAPACITY));
+	}
+
+	for(std::size_t idx = 0; idx < _pool_size; ++idx)
+	{
+		mWorkers.push_back(std::thread(std::bind(&ThreadPool::_worker_func, this, idx)));
 	}
 }
 
 ThreadPool::~ThreadPool()
 {
-	mRunning = false;
+	{
+		std::lock_guard<std::mutex> lock(mSleepMutex);
+		mRunning = false;
+	}
+	mSleepCondition.notify_all();
+
 	for(std::thread& thr : mWorkers)
 	{
-		mQueueCondition.notify_all();
 		thr.join();
 	}
+
+	// drop tasks that were never started
+	task_func task;
+	while(_find_task(task))
+		task.reset();
+}
+
+std::size_t ThreadPool::default_size()
+{
+	const std::size_t hw = std::thread::hardware_concurrency();
+	return hw > 0? hw : 4;
+}
+
+std::size_t ThreadPool::size() const
+{
+	return mWorkers.size();
 }
 
 
 void ThreadPool::complete()
 {
-	std::unique_lock<std::mutex> lock(mQueueMutex);
+	// help as long as there is something to do
+	while(!empty() && _run_pending_task())
+	{
+	}
+
+	std::unique_lock<std::mutex> lock(mCompleteMutex);
 	while(!empty())
 	{
 		mCompleteCondition.wait(lock);
@@ -38,30 +98,144 @@ bool ThreadPool::empty() const
 	return mCurrentTasks == 0;
 }
 
+ThreadPool* ThreadPool::_current_pool()
+{
+	return GCurrentPool;
+}
 
-void ThreadPool::_worker_func()
+void ThreadPool::_push( task_func&& task )
 {
-	while(mRunning)
+	++mCurrentTasks;
+	++mQueuedTasks;
+
+	if(GCurrentPool == this)
 	{
-		task_func task;
+		_push_local(std::move(task));
+	}else{
+		while(!mInjectedTasks.try_push(std::move(task)))
 		{
-			std::unique_lock<std::mutex> lock(mQueueMutex);
-			while(mTasks.empty())
-			{
-				mQueueCondition.wait(lock);
-				if(!mRunning)
-					return;
-			}
-			task = mTasks.front();
-			mTasks.pop_front();
+			// queue full, do some of the work ourselves
+			if(!_run_pending_task())
+				std::this_thread::yield();
 		}
+	}
 
-		task();
+	_wake_workers(1);
+}
 
-		assert(mCurrentTasks > 0);
-		--mCurrentTasks;
+void ThreadPool::_push_local( task_func&& task )
+{
+	assert(GCurrentPool == this);
 
-		if(mCurrentTasks == 0)
-			mCompleteCondition.notify_all();
+	task_func* node = NewTaskNode(std::move(task));
+	if(mDeques[GCurrentWorker]->push(node))
+		return;
+
+	// own deque is full
+	while(!mInjectedTasks.try_push(std::move(*node)))
+	{
+		if(!_run_pending_task())
+			std::this_thread::yield();
+	}
+	DeleteTaskNode(node);
+}
+
+void ThreadPool::_wake_workers( std::size_t count )
+{
+	// a worker that goes to sleep increments mSleepingWorkers before it checks mQueuedTasks,
+	// so either it sees the new tasks or we see it sleeping
+	if(mSleepingWorkers > 0)
+	{
+		std::lock_guard<std::mutex> lock(mSleepMutex);
+		if(count > 1)
+			mSleepCondition.notify_all();
+		else
+			mSleepCondition.notify_one();
+	}
+}
+
+bool ThreadPool::_find_task( task_func& task )
+{
+	const bool is_worker = (GCurrentPool == this);
+	const std::size_t self = is_worker? GCurrentWorker : 0;
+	task_func* node = nullptr;
+
+	if(is_worker)
+		node = mDeques[self]->pop();
+
+	if(!node && mInjectedTasks.try_pop(task))
+	{
+		--mQueuedTasks;
+		return true;
+	}
+
+	const std::size_t count = mDeques.size();
+	for(std::size_t off = is_worker? 1 : 0; !node && off < count; ++off)
+	{
+		node = mDeques[(self + off) % count]->steal();
+	}
+
+	if(!node)
+		return false;
+
+	--mQueuedTasks;
+	task = std::move(*node);
+	DeleteTaskNode(node);
+	return true;
+}
+
+bool ThreadPool::_run_pending_task()
+{
+	task_func task;
+	if(!_find_task(task))
+		return false;
+
+	task();
+	task.reset();
+
+	assert(mCurrentTasks > 0);
+	if(--mCurrentTasks == 0)
+	{
+		std::lock_guard<std::mutex> lock(mCompleteMutex);
+		mCompleteCondition.notify_all();
+	}
+	return true;
+}
+
+void ThreadPool::_wait_for( const std::atomic<std::size_t>& counter )
+{
+	while(counter > 0)
+	{
+		if(!_run_pending_task())
+			std::this_thread::yield();
+	}
+}
+
+void ThreadPool::_worker_func(std::size_t index)
+{
+	GCurrentPool = this;
+	GCurrentWorker = index;
+
+	while(mRunning)
+	{
+		if(_run_pending_task())
+			continue;
+
+		bool found = false;
+		for(std::size_t spin = 0; spin < IDLE_SPIN_COUNT && !found; ++spin)
+		{
+			std::this_thread::yield();
+			found = _run_pending_task();
+		}
+		if(found)
+			continue;
+
+		std::unique_lock<std::mutex> lock(mSleepMutex);
+		++mSleepingWorkers;
+		while(mRunning && mQueuedTasks == 0)
+		{
+			mSleepCondition.wait(lock);
+		}
+		--mSleepingWorkers;
 	}
 }
@@ -3,59 +3,208 @@
 #define _THREAD_POOL_HPP
 
 
+#include <algorithm>
 #include <condition_variable>
-#include <queue>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <mutex>
 #include <thread>
 #include <atomic>
 #include <vector>
+#include <memory>
+#include "work_stealing_deque.hpp"
+#include "mpmc_queue.hpp"
+#include "task.hpp"
 
 
-
+// Work stealing thread pool.
+// Every worker owns a deque for the tasks it posts itself, tasks posted by
+// other threads go to a shared lock-free injection queue. Idle workers steal from the others.
 class ThreadPool
 {
 public:
-	typedef std::function<void()> task_func;
+	typedef Task task_func;
 public:
-	ThreadPool(std::size_t _pool_size);
+	// a pool size of 0 uses default_size()
+	ThreadPool(std::size_t _pool_size = 0);
+	// Joins the workers. Tasks that were posted but not started yet are dropped without
+	// running, call complete() first if they have to run.
 	~ThreadPool();
 
+	// number of hardware threads
+	static std::size_t default_size();
+
+	std::size_t size() const;
+
+	// waits until all posted tasks are done, the calling thread helps executing them
 	void complete();
 
-	template<class Task>
-	void post(Task task)
+	template<class Func>
+	void post(Func&& func)
 	{
-		{ // acquire lock
-			std::unique_lock<std::mutex> lock(mQueueMutex);
-
-			// add the task
-			mTasks.push_back(task_func(task));
+		_push(task_func(std::forward<Func>(func)));
+	}
 
-			++mCurrentTasks;
-		} // release lock
+	// posts a task for every callable in [first, last), tasks from outside the pool
+	// are enqueued with a single reservation in the injection queue
+	template<class Iter>
+	void post_range(Iter first, Iter last)
+	{
+		const std::size_t count = std::distance(first, last);
+		if(count == 0)
+			return;
+
+		mCurrentTasks += count;
+		mQueuedTasks += count;
+
+		if(_current_pool() == this)
+		{
+			for(; first != last; ++first)
+				_push_local(task_func(*first));
+		}else{
+			while(first != last)
+			{
+				const std::size_t chunk = std::min<std::size_t>(std::distance(first, last), mInjectedTasks.capacity());
+				while(!mInjectedTasks.try_push_range(first, chunk))
+				{
+					// queue full, do some of the work ourselves
+					if(!_run_pending_task())
+						std::this_thread::yield();
+				}
+				std::advance(first, chunk);
+			}
+		}
+
+		_wake_workers(count);
+	}
 
-		// wake up one thread
-		mQueueCondition.notify_one();
+	// Calls func(first, last) for disjoint chunks of [begin, end) with at most grain elements
+	// and returns when all chunks are done. The range is split recursively, so idle workers
+	// steal big halves instead of single chunks. Can be nested inside tasks.
+	// If func throws, the chunks not started yet are skipped and the first exception is
+	// rethrown once all running chunks are done.
+	template<class Func>
+	void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, const Func& func)
+	{
+		ForkState state;
+		try
+		{
+			_fork(begin, end, std::max<std::size_t>(grain, 1), func, state);
+		}catch(...)
+		{
+			state.fail(std::current_exception());
+		}
+
+		// the posted halves reference func and state, so wait for them in any case
+		_wait_for(state.pending);
+		if(state.error)
+			std::rethrow_exception(state.error);
 	}
 
 	bool empty() const;
 private:
-	void _worker_func();
+	typedef WorkStealingDeque<task_func*> deque_type;
+	typedef MPMCQueue<task_func> inject_queue_type;
+
+	// shared by all chunks of one parallel_for
+	struct ForkState
+	{
+		ForkState()
+			: pending(0)
+			, failed(false)
+		{
+		}
+
+		// keeps the first exception, error is read only after pending dropped to 0
+		void fail(std::exception_ptr exception)
+		{
+			if(!failed.exchange(true))
+				error = exception;
+		}
+
+		std::atomic<std::size_t> pending;
+		std::atomic<bool> failed;
+		std::exception_ptr error;
+	};
+
+	// a posted half counts as done when its task ends, also by an exception
+	struct PendingGuard
+	{
+		PendingGuard(std::atomic<std::size_t>& pending)
+			: mPending(pending)
+		{
+		}
+
+		~PendingGuard()
+		{
+			--mPending;
+		}
+
+		std::atomic<std::size_t>& mPending;
+	};
+
+	template<class Func>
+	void _fork(std::size_t begin, std::size_t end, std::size_t grain, const Func& func, ForkState& state)
+	{
+		while(end - begin > grain)
+		{
+			const std::size_t mid = begin + (end - begin) / 2;
+			++state.pending;
+			try
+			{
+				post([this, mid, end, grain, &func, &state]{
+					PendingGuard guard(state.pending);
+					try
+					{
+						_fork(mid, end, grain, func, state);
+					}catch(...)
+					{
+						state.fail(std::current_exception());
+					}
+				});
+			}catch(...)
+			{
+				--state.pending;
+				throw;
+			}
+			end = mid;
+		}
+
+		if(!state.failed)
+			func(begin, end);
+	}
+
+	static ThreadPool* _current_pool();
+
+	void _push(task_func&& task);
+	void _push_local(task_func&& task);
+	void _wake_workers(std::size_t count);
+	bool _find_task(task_func& task);
+	bool _run_pending_task();
+	void _wait_for(const std::atomic<std::size_t>& counter);
+	void _worker_func(std::size_t index);
 
 private:
 
 	// need to keep track of threads so we can join them
 	std::vector<std::thread> mWorkers;
 
-	// the task queue
-	std::deque<task_func> mTasks;
+	// one deque per worker and the queue for tasks from outside
+	std::vector<std::unique_ptr<deque_type>> mDeques;
+	inject_queue_type mInjectedTasks;
 
 	// synchronization
-	std::mutex mQueueMutex;
-	std::condition_variable mQueueCondition;
+	std::mutex mSleepMutex;
+	std::condition_variable mSleepCondition;
+	std::atomic<std::size_t> mSleepingWorkers;
+	std::atomic<std::size_t> mQueuedTasks;
+
+	std::mutex mCompleteMutex;
 	std::condition_variable mCompleteCondition;
-	bool mRunning;
+	std::atomic<bool> mRunning;
 	std::atomic<std::size_t> mCurrentTasks;
 };
 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,181 @@
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <stdexcept>
+#include "tick_reader.hpp"
+
+
+
+TickReader::TickReader( const std::string& path, const TickFormat& format, std::size_t chunk_size )
+	: mPath(path)
+	, mFormat(format)
+	, mStream(path.c_str(), std::ios::binary)
+	, mChunk(chunk_size + 1)	// room to terminate the last line
+	, mPos(0)
+	, mEnd(0)
+	, mEof(false)
+	, mBytesRead(0)
+	, mLinesRead(0)
+	, mSkippedLines(0)
+{
+	assert(chunk_size > 0);
+	if(!mStream)
+		throw std::runtime_error("can not open tick file '" + path + "'");
+}
+
+TickReader::~TickReader()
+{
+}
+
+std::size_t TickReader::read( float* values, std::size_t count )
+{
+	std::size_t read_count = 0;
+	char* begin;
+	char* end;
+
+	while(read_count < count && _next_line(begin, end))
+	{
+		if(mLinesRead++ < mFormat.skip_lines)
+			continue;
+
+		if(_parse(begin, end, values[read_count]))
+			++read_count;
+		else
+			++mSkippedLines;
+	}
+	return read_count;
+}
+
+void TickReader::rewind()
+{
+	mStream.clear();
+	mStream.seekg(0);
+	mPos = mEnd = 0;
+	mEof = false;
+	mBytesRead = 0;
+	mLinesRead = 0;
+	mSkippedLines = 0;
+}
+
+std::uint64_t TickReader::bytes_read() const
+{
+	return mBytesRead;
+}
+
+std::uint64_t TickReader::lines_read() const
+{
+	return mLinesRead;
+}
+
+std::uint64_t TickReader::skipped_lines() const
+{
+	return mSkippedLines;
+}
+
+bool TickReader::_next_line( char*& begin, char*& end )
+{
+	for(;;)
+	{
+		char* data = mChunk.data();
+		char* newline = static_cast<char*>(std::memchr(data + mPos, '\n', mEnd - mPos));
+		if(newline)
+		{
+			begin = data + mPos;
+			end = newline;
+			mPos = std::size_t(newline - data) + 1;
+			return true;
+		}
+
+		if(!mEof)
+		{
+			_fill();
+			continue;
+		}
+
+		// last line without line break
+		if(mPos < mEnd)
+		{
+			begin = data + mPos;
+			end = data + mEnd;
+			mPos = mEnd;
+			return true;
+		}
+		return false;
+	}
+}
+
+bool TickReader::_fill()
+{
+	const std::size_t capacity = mChunk.size() - 1;
+	const std::size_t rest = mEnd - mPos;
+	if(rest == capacity)
+		throw std::runtime_error("line in '" + mPath + "' is longer than the chunk size");
+
+	std::memmove(mChunk.data(), mChunk.data() + mPos, rest);
+	mPos = 0;
+	mEnd = rest;
+
+	mStream.read(mChunk.data() + mEnd, std::streamsize(capacity - mEnd));
+	const std::size_t got = std::size_t(mStream.gcount());
+	mEnd += got;
+	mBytesRead += got;
+
+	if(got == 0)
+		mEof = true;
+	return got > 0;
+}
+
+bool TickReader::_parse( char* begin, char* end, float& value ) const
+{
+	if(end > begin && end[-1] == '\r')
+		--end;
+
+	// find the field
+	char* field_begin = begin;
+	char* field_end = end;
+	if(mFormat.column >= 0)
+	{
+		for(int col = 0; col < mFormat.column; ++col)
+		{
+			char* delim = static_cast<char*>(std::memchr(field_begin, mFormat.delimiter, end - field_begin));
+			if(!delim)
+				return false;
+			field_begin = delim + 1;
+		}
+		char* delim = static_cast<char*>(std::memchr(field_begin, mFormat.delimiter, end - field_begin));
+		if(delim)
+			field_end = delim;
+	}else{
+		for(int col = -1; ; --col)
+		{
+			char* it = field_end;
+			while(it > begin && it[-1] != mFormat.delimiter)
+				--it;
+			field_begin = it;
+			if(col == mFormat.column)
+				break;
+			if(it == begin)
+				return false;
+			field_end = it - 1;
+		}
+	}
+
+	// strip quotes
+	if(field_end - field_begin >= 2 && *field_begin == '"' && field_end[-1] == '"')
+	{
+		++field_begin;
+		--field_end;
+	}
+
+	// the buffer has one spare byte behind every line, so the field can be terminated in place
+	*field_end = '\0';
+	char* stop;
+	value = std::strtof(field_begin, &stop);
+	if(stop == field_begin)
+		return false;
+
+	while(std::isspace(static_cast<unsigned char>(*stop)))
+		++stop;
+	return *stop == '\0';
+}
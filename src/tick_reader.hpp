@@ -0,0 +1,65 @@
+#pragma once
+#ifndef _TICK_READER_HPP
+#define _TICK_READER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+
+
+struct TickFormat
+{
+	TickFormat()
+		: delimiter(',')
+		, column(-1)
+		, skip_lines(0)
+	{
+	}
+
+	char delimiter;
+	// column of the value, negative counts from the end (-1 = last column)
+	int column;
+	std::size_t skip_lines;
+};
+
+
+// Reads the values of one column from a csv or line based tick file.
+// The file is read in chunks of a fixed size, so files of any size are
+// processed with constant memory. Lines without a number in the column
+// (e.g. headers) are skipped and counted.
+class TickReader
+{
+public:
+	TickReader(const std::string& path, const TickFormat& format, std::size_t chunk_size = 1 << 20);
+	~TickReader();
+
+	// reads up to count values, returns 0 at the end of the file
+	std::size_t read(float* values, std::size_t count);
+
+	// starts again at the beginning of the file
+	void rewind();
+
+	std::uint64_t bytes_read() const;
+	std::uint64_t lines_read() const;
+	std::uint64_t skipped_lines() const;
+
+private:
+	bool _next_line(char*& begin, char*& end);
+	bool _fill();
+	bool _parse(char* begin, char* end, float& value) const;
+
+private:
+	const std::string mPath;
+	const TickFormat mFormat;
+	std::ifstream mStream;
+	std::vector<char> mChunk;
+	std::size_t mPos;
+	std::size_t mEnd;
+	bool mEof;
+	std::uint64_t mBytesRead;
+	std::uint64_t mLinesRead;
+	std::uint64_t mSkippedLines;
+};
+
+#endif
@@ -0,0 +1,87 @@
+#pragma once
+#ifndef _TRADER_BATCH_HPP
+#define _TRADER_BATCH_HPP
+
+#include <cassert>
+#include <vector>
+#include "basic_trader.hpp"
+
+
+// The state of many traders on the same chart, stored as structure of arrays.
+// A trader holds at most one order, so its state is the capital, the position (1 long,
+// -1 short, 0 none) and the entrance price (0 without an order). act() advances all traders
+// by one tick with selects instead of branches, so the loop runs through contiguous memory
+// and can be vectorized. Gives the same capital as BasicTrader driven by Entity::act.
+template<typename Charge>
+class TraderBatch
+{
+public:
+	TraderBatch(std::size_t trader_count, float capital, const Charge& charge = Charge())
+		: mCharge(charge)
+		, mCapital(trader_count, capital)
+		, mPosition(trader_count, 0.0f)
+		, mEntrance(trader_count, 0.0f)
+	{
+	}
+
+	std::size_t trader_count() const
+	{
+		return mCapital.size();
+	}
+
+	// one value per trader
+	const float* capital() const
+	{
+		return mCapital.data();
+	}
+
+	const float* position() const
+	{
+		return mPosition.data();
+	}
+
+	const float* entrance() const
+	{
+		return mEntrance.data();
+	}
+
+	// Outputs of at least 0.5 mean yes: a trader that does something either enters with an
+	// order of entry_type if it is not trading or leaves its order.
+	void act(float price, const float* do_something, const float* enter_or_leave, OrderType entry_type)
+	{
+		assert(price >= 0.0f);
+
+		const float fee = mCharge(price);
+		const float side = entry_type == LongOrder? 1.0f : -1.0f;
+		float* capital = mCapital.data();
+		float* position = mPosition.data();
+		float* entrance = mEntrance.data();
+		const std::size_t count = trader_count();
+
+		for(std::size_t idx = 0; idx < count; ++idx)
+		{
+			const bool act = do_something[idx] >= 0.5f;
+			const bool enter = enter_or_leave[idx] >= 0.5f;
+			const bool trading = position[idx] != 0.0f;
+			const bool breach = act && enter && !trading;
+			const bool leave = act && !enter && trading;
+
+			float value = capital[idx];
+			value = (breach || leave)? value - fee : value;
+			value = leave? value + position[idx] * (price - entrance[idx]) : value;
+			capital[idx] = value;
+
+			position[idx] = breach? side : (leave? 0.0f : position[idx]);
+			entrance[idx] = breach? price : (leave? 0.0f : entrance[idx]);
+		}
+	}
+
+private:
+	Charge mCharge;
+	std::vector<float> mCapital;
+	std::vector<float> mPosition;
+	std::vector<float> mEntrance;
+};
+
+
+#endif
@@ -0,0 +1,111 @@
+#pragma once
+#ifndef _WORK_STEALING_DEQUE_HPP
+#define _WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <memory>
+#include <cassert>
+#include <cstdint>
+
+
+// Chase-Lev work stealing deque with a fixed capacity
+// (after Le, Pop, Cohen, Zappa Nardelli: "Correct and Efficient Work-Stealing for Weak Memory Models").
+// Only the owning thread may push and pop at the bottom, every thread may steal from the top.
+// T has to be a pointer like type, a default constructed T signals "no item".
+template<typename T>
+class WorkStealingDeque
+{
+public:
+	typedef T value_type;
+
+public:
+	WorkStealingDeque(std::size_t capacity)
+		: mTop(0)
+		, mBottom(0)
+		, mMask(capacity - 1)
+		, mBuffer(new std::atomic<value_type>[capacity])
+	{
+		assert(capacity > 0 && (capacity & mMask) == 0);
+	}
+
+	~WorkStealingDeque()
+	{
+	}
+
+	std::size_t capacity() const
+	{
+		return mMask + 1;
+	}
+
+	bool empty() const
+	{
+		return mBottom.load(std::memory_order_relaxed) <= mTop.load(std::memory_order_relaxed);
+	}
+
+	// owner only, returns false if the deque is full
+	bool push(value_type item)
+	{
+		const std::int64_t b = mBottom.load(std::memory_order_relaxed);
+		const std::int64_t t = mTop.load(std::memory_order_acquire);
+		if(b - t >= std::int64_t(capacity()))
+			return false;
+
+		mBuffer[b & mMask].store(item, std::memory_order_relaxed);
+		mBottom.store(b + 1, std::memory_order_release);
+		return true;
+	}
+
+	// owner only
+	value_type pop()
+	{
+		const std::int64_t b = mBottom.load(std::memory_order_relaxed) - 1;
+		mBottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		std::int64_t t = mTop.load(std::memory_order_relaxed);
+
+		value_type item = value_type();
+		if(t <= b)
+		{
+			item = mBuffer[b & mMask].load(std::memory_order_relaxed);
+			if(t == b)
+			{
+				// last item, race against the thieves
+				if(!mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					item = value_type();
+				mBottom.store(b + 1, std::memory_order_relaxed);
+			}
+		}else{
+			mBottom.store(b + 1, std::memory_order_relaxed);
+		}
+		return item;
+	}
+
+	// any thread, fails if the deque is empty or another thread was faster
+	value_type steal()
+	{
+		std::int64_t t = mTop.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const std::int64_t b = mBottom.load(std::memory_order_acquire);
+
+		if(t < b)
+		{
+			value_type item = mBuffer[t & mMask].load(std::memory_order_relaxed);
+			if(mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return item;
+		}
+		return value_type();
+	}
+
+private:
+	WorkStealingDeque(const WorkStealingDeque&);
+	WorkStealingDeque& operator =(const WorkStealingDeque&);
+
+private:
+	std::atomic<std::int64_t> mTop;
+	std::atomic<std::int64_t> mBottom;
+	const std::size_t mMask;
+	std::unique_ptr<std::atomic<value_type>[]> mBuffer;
+};
+
+
+#endif
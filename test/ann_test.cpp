@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+#include "ann.hpp"
+#include "ann_batch.hpp"
+#include "ann_static.hpp"
+#include "philox.hpp"
+
+
+typedef ANN<3, 2> TestANN;
+typedef ANNBatch<3, 2> TestBatch;
+
+static const float ANN_TOLERANCE = 1e-5f;
+
+// network count is not a multiple of any simd width, so the kernel tails are used too
+static const std::size_t NETWORK_COUNT = 37;
+
+static float InputValue(std::size_t network, std::size_t neuron)
+{
+	return 0.1f * float(network % 11) - 0.4f * float(neuron) + 0.05f;
+}
+
+// every network of the batch has to give the outputs of the same weights in ANN
+static void CheckBatchAgainstAnn(std::size_t hidden, std::size_t layers, float act_response)
+{
+	const TestANN::format_type format(hidden, layers);
+	const std::size_t wcount = format.weights_count();
+	Philox4x32 rng(7 + hidden + layers);
+
+	TestANN::weight_list weights = TestANN::weight_list::New(wcount * NETWORK_COUNT);
+	TestBatch batch(format, NETWORK_COUNT, act_response);
+	for(std::size_t net = 0; net < NETWORK_COUNT; ++net)
+	{
+		TestANN::random_weights(format, rng, weights.data() + net * wcount);
+		batch.load(net, weights.data() + net * wcount);
+		for(std::size_t i = 0; i < format.input_neurons(); ++i)
+			batch.in(i)[net] = InputValue(net, i);
+	}
+	batch.process();
+
+	for(std::size_t net = 0; net < NETWORK_COUNT; ++net)
+	{
+		TestANN::weight_list net_weights = TestANN::weight_list::New(wcount);
+		std::copy(weights.data() + net * wcount, weights.data() + (net + 1) * wcount, net_weights.begin());
+		TestANN ann(format, std::move(net_weights), act_response);
+		TestANN::data_type data(format);
+		for(std::size_t i = 0; i < format.input_neurons(); ++i)
+			data.in[i] = InputValue(net, i);
+		ann.process(data);
+
+		for(std::size_t o = 0; o < format.output_neurons(); ++o)
+			BOOST_CHECK_SMALL(batch.out(o)[net] - data.out[o], ANN_TOLERANCE);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ann_batch_matches_ann)
+{
+	CheckBatchAgainstAnn(5, 0, 1.0f);
+	CheckBatchAgainstAnn(5, 3, 1.0f);
+	CheckBatchAgainstAnn(64, 2, 0.5f);
+}
+
+BOOST_AUTO_TEST_CASE(ann_static_matches_ann)
+{
+	typedef ANNStatic<3, 5, 3, 2> TestStatic;
+	const TestANN::format_type format = TestStatic::format();
+	Philox4x32 rng(3);
+
+	for(std::size_t net = 0; net < NETWORK_COUNT; ++net)
+	{
+		TestANN::weight_list weights = TestANN::weight_list::New(format.weights_count());
+		TestANN::random_weights(format, rng, weights.data());
+		TestANN ann(format, std::move(weights), 0.75f);
+		const TestStatic fixed(ann);
+
+		TestANN::data_type data(format);
+		TestStatic::input_type in;
+		for(std::size_t i = 0; i < format.input_neurons(); ++i)
+			data.in[i] = in[i] = InputValue(net, i);
+
+		ann.process(data);
+		const TestStatic::output_type out = fixed.process(in);
+		for(std::size_t o = 0; o < format.output_neurons(); ++o)
+			BOOST_CHECK_SMALL(out[o] - data.out[o], ANN_TOLERANCE);
+	}
+}
@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "chart_generator.hpp"
+#include "chart_model.hpp"
+
+
+static const std::size_t TICK_COUNT = 300;
+static const float MIN_VALUE = 10.0f;
+static const float MAX_VALUE = 50.0f;
+static const float VOLATILITY = 0.2f;
+static const std::uint64_t SEED = 42;
+
+// a chart only depends on (seed, chart index), not on the range it was generated with
+BOOST_AUTO_TEST_CASE(generate_walks_is_reproducible_per_index)
+{
+	// two full lane groups and a partial one
+	const std::size_t chart_count = 2 * GENERATOR_LANES + 5;
+	std::vector<float> all(chart_count * TICK_COUNT);
+	GenerateWalks(all.data(), TICK_COUNT, TICK_COUNT, 0, chart_count, MIN_VALUE, MAX_VALUE, VOLATILITY, SEED);
+
+	// an unaligned range with another stride
+	const std::size_t first = 7;
+	const std::size_t count = GENERATOR_LANES + 3;
+	const std::size_t stride = TICK_COUNT + 13;
+	std::vector<float> part(count * stride);
+	GenerateWalks(part.data(), stride, TICK_COUNT, first, count, MIN_VALUE, MAX_VALUE, VOLATILITY, SEED);
+
+	ChartModel model(MIN_VALUE, MAX_VALUE, VOLATILITY, TICK_COUNT);
+	for(std::size_t chart = 0; chart < chart_count; ++chart)
+	{
+		const float* values = all.data() + chart * TICK_COUNT;
+		model.generate(SEED, chart);
+		BOOST_CHECK_EQUAL_COLLECTIONS(values, values + TICK_COUNT, model.values(), model.values() + TICK_COUNT);
+
+		if(chart >= first && chart < first + count)
+		{
+			const float* other = part.data() + (chart - first) * stride;
+			BOOST_CHECK_EQUAL_COLLECTIONS(values, values + TICK_COUNT, other, other + TICK_COUNT);
+		}
+	}
+
+	std::vector<float> reseeded(TICK_COUNT);
+	GenerateWalks(reseeded.data(), TICK_COUNT, TICK_COUNT, 0, 1, MIN_VALUE, MAX_VALUE, VOLATILITY, SEED + 1);
+	BOOST_CHECK(!std::equal(reseeded.begin(), reseeded.end(), all.begin()));
+}
+
+BOOST_AUTO_TEST_CASE(generate_walks_stays_in_bounds)
+{
+	const std::size_t chart_count = GENERATOR_LANES;
+	std::vector<float> values(chart_count * TICK_COUNT);
+	// a high volatility hits the bounds often
+	GenerateWalks(values.data(), TICK_COUNT, TICK_COUNT, 0, chart_count, MIN_VALUE, MAX_VALUE, 1.5f, SEED);
+
+	for(std::size_t idx = 0; idx < values.size(); ++idx)
+	{
+		BOOST_CHECK_GE(values[idx], MIN_VALUE);
+		BOOST_CHECK_LE(values[idx], MAX_VALUE);
+	}
+}
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <random>
+#include <boost/test/unit_test.hpp>
+#include "chart_plot.hpp"
+#include "sliding_series.hpp"
+
+
+struct PlotVertex
+{
+	float x;
+	float y;
+};
+
+struct PlotVertexFactory
+{
+	typedef PlotVertex vertex_type;
+
+	PlotVertex operator ()(float x, float y) const
+	{
+		PlotVertex vertex = {x, y};
+		return vertex;
+	}
+};
+
+// a sliding window with the running index as x, the whole window is visible
+class SeriesData: public ChartData
+{
+public:
+	SeriesData(std::size_t window_size)
+		: mSeries(window_size)
+	{
+	}
+
+	void push(float value) { mSeries.push(value); }
+	float value(std::size_t idx) const { return mSeries.value(idx); }
+
+	virtual float min_x() const { return float(mSeries.first_index()); }
+	virtual float max_x() const { return float(mSeries.first_index() + mSeries.size() - 1); }
+	virtual float min_y() const { return mSeries.min_value(); }
+	virtual float max_y() const { return mSeries.max_value(); }
+
+	virtual std::size_t data_count() const { return mSeries.size(); }
+	virtual void data_point(int idx, float* x, float* y) const
+	{
+		*x = float(mSeries.first_index() + std::size_t(idx));
+		*y = mSeries.value(std::size_t(idx));
+	}
+
+	virtual std::size_t first_index() const { return mSeries.first_index(); }
+	virtual bool data_span(std::size_t first, ChartSpan* span) const
+	{
+		span->y = mSeries.values(first, &span->count);
+		span->x = nullptr;
+		span->x0 = float(mSeries.first_index() + first);
+		span->x_step = 1.0f;
+		return true;
+	}
+
+private:
+	SeriesData(const SeriesData&);
+	SeriesData& operator =(const SeriesData&);
+
+private:
+	SlidingSeries mSeries;
+};
+
+static const std::size_t WINDOW_SIZE = 500;
+
+// the plot has to follow a sliding window in both modes as if it was rebuilt every update
+BOOST_AUTO_TEST_CASE(chart_plot_follows_sliding_window)
+{
+	// 300 columns show every point of the window, 40 columns are decimated once there are 80 points
+	static const std::size_t COLUMNS[] = {300, 40};
+
+	SeriesData data(WINDOW_SIZE);
+	ChartPlot<PlotVertexFactory> plot(&data);
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+	std::uniform_int_distribution<std::size_t> pushes(0, 70);
+
+	for(std::size_t round = 0; round < 60; ++round)
+	{
+		const std::size_t push_count = pushes(rng);
+		for(std::size_t idx = 0; idx < push_count; ++idx)
+			data.push(value(rng));
+		if(data.data_count() == 0)
+			continue;
+
+		const std::size_t columns = COLUMNS[(round / 7) % 2];
+		plot.update(columns);
+
+		const std::size_t count = data.data_count();
+		const PlotVertex* vertices = plot.vertices();
+		if(count <= 2 * columns)
+		{
+			BOOST_CHECK(!plot.shows_columns());
+			BOOST_REQUIRE_EQUAL(plot.vertex_count(), count);
+			for(std::size_t idx = 0; idx < count; ++idx)
+			{
+				BOOST_CHECK_EQUAL(vertices[idx].x, float(data.first_index() + idx));
+				BOOST_CHECK_EQUAL(vertices[idx].y, data.value(idx));
+			}
+		}else{
+			BOOST_CHECK(plot.shows_columns());
+			BOOST_REQUIRE_EQUAL(plot.vertex_count(), 2 * columns);
+			for(std::size_t column = 0; column < columns; ++column)
+			{
+				const std::size_t begin = count * column / columns;
+				const std::size_t end = count * (column + 1) / columns;
+				float low = data.value(begin);
+				float high = low;
+				for(std::size_t idx = begin; idx < end; ++idx)
+				{
+					low = std::min(low, data.value(idx));
+					high = std::max(high, data.value(idx));
+				}
+
+				BOOST_CHECK_EQUAL(vertices[2 * column].y, low);
+				BOOST_CHECK_EQUAL(vertices[2 * column + 1].y, high);
+				BOOST_CHECK(vertices[2 * column].x >= data.min_x() && vertices[2 * column].x <= data.max_x());
+			}
+		}
+	}
+}
@@ -0,0 +1,40 @@
+#include <random>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "ai_test.hpp"
+#include "chart_model.hpp"
+#include "trader_batch.hpp"
+
+
+// TraderBatch has to give the capital of BasicTrader driven by Entity::act, bit for bit
+BOOST_AUTO_TEST_CASE(trader_batch_matches_basic_trader)
+{
+	static const std::size_t TRADER_COUNT = 19;
+	static const float CAPITAL = 1000.0f;
+
+	ChartModel chart(10.0f, 200.0f, 0.05f, 2000);
+	chart.generate(std::uint64_t(5), 0);
+
+	TraderBatch<EntityCharge> batch(TRADER_COUNT, CAPITAL);
+	std::vector<SimulationTrader> traders(TRADER_COUNT, SimulationTrader(CAPITAL));
+	std::vector<float> do_something(TRADER_COUNT);
+	std::vector<float> enter_or_leave(TRADER_COUNT);
+
+	std::mt19937 rng(11);
+	std::uniform_real_distribution<float> output(0.0f, 1.0f);
+
+	for(std::size_t tick = 0; tick < chart.tick_count(); ++tick)
+	{
+		const float price = chart.values()[tick];
+		for(std::size_t idx = 0; idx < TRADER_COUNT; ++idx)
+		{
+			do_something[idx] = output(rng);
+			enter_or_leave[idx] = output(rng);
+			Entity::act(traders[idx], price, do_something[idx], enter_or_leave[idx]);
+		}
+		batch.act(price, do_something.data(), enter_or_leave.data(), Entity::ENTRY_ORDER);
+	}
+
+	for(std::size_t idx = 0; idx < TRADER_COUNT; ++idx)
+		BOOST_CHECK_EQUAL(batch.capital()[idx], traders[idx].capital());
+}
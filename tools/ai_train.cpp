@@ -0,0 +1,138 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+#include "ai_test.hpp"
+
+
+// Trains without any window, so it can run on servers and uses all cores.
+
+
+class ConsoleObserver: public AiTestObserver
+{
+public:
+	ConsoleObserver(std::size_t report_interval)
+		: mReportInterval(report_interval)
+		, mStart(std::chrono::high_resolution_clock::now())
+	{
+	}
+
+	virtual void generation_done( const PopulationStats& stats )
+	{
+		if((stats.generation + 1) % mReportInterval != 0)
+			return;
+
+		using namespace std::chrono;
+		const double seconds = duration_cast<duration<double>>(high_resolution_clock::now() - mStart).count();
+		std::cout << "Gen " << stats.generation << "[" << stats.min_fitness << ", " << stats.avg_fitness << ", " << stats.max_fitness << "] "
+			<< double(stats.generation + 1) / seconds << " gens/s" << std::endl;
+	}
+
+private:
+	const std::size_t mReportInterval;
+	const std::chrono::high_resolution_clock::time_point mStart;
+};
+
+
+static void PrintUsage()
+{
+	std::cerr << "usage: ai-train [options]\n"
+		<< "  --generations N      generations to train, 0 trains forever (default 0)\n"
+		<< "  --population N       entities per generation (default 100)\n"
+		<< "  --threads N          worker threads, 0 uses all hardware threads (default 0)\n"
+		<< "  --seed S             seed for the corpus and the breeding, 0 seeds from the clock (default 0)\n"
+		<< "  --corpus PATH        chart file to train on, a corpus is generated if not given\n"
+		<< "  --corpus-size N      charts of the generated corpus (default 64)\n"
+		<< "  --scenarios N        charts every entity is evaluated on (default 8)\n"
+		<< "  --mode M             batched or entity (default batched)\n"
+		<< "  --aggregation A      mean, min or quantile (default mean)\n"
+		<< "  --quantile Q         quantile used by the quantile aggregation (default 0.25)\n"
+		<< "  --normalize B        1 scores every chart relative to its best trade (default 0)\n"
+		<< "  --selection S        roulette, sus, tournament or rank (default roulette)\n"
+		<< "  --tournament-size N  entities per tournament (default 3)\n"
+		<< "  --rank-pressure P    linear ranking pressure in [1, 2] (default 1.5)\n"
+		<< "  --report N           print every Nth generation (default 1)\n";
+}
+
+static bool ParseArguments( int argc, char** argv, TrainingSettings& settings, std::size_t& report_interval )
+{
+	for(int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if(i + 1 >= argc)
+			return false;
+		const std::string value = argv[++i];
+
+		if(arg == "--generations")
+			settings.generation_limit = std::size_t(std::atol(value.c_str()));
+		else if(arg == "--population")
+			settings.population_size = std::size_t(std::atol(value.c_str()));
+		else if(arg == "--threads")
+			settings.thread_count = std::size_t(std::atol(value.c_str()));
+		else if(arg == "--seed")
+			settings.seed = unsigned(std::strtoul(value.c_str(), nullptr, 10));
+		else if(arg == "--corpus")
+			settings.corpus_path = value;
+		else if(arg == "--corpus-size")
+			settings.corpus_size = std::size_t(std::atol(value.c_str()));
+		else if(arg == "--scenarios")
+			settings.evaluation.scenario_count = std::size_t(std::atol(value.c_str()));
+		else if(arg == "--quantile")
+			settings.evaluation.quantile = float(std::atof(value.c_str()));
+		else if(arg == "--normalize")
+			settings.evaluation.normalize_fitness = std::atoi(value.c_str()) != 0;
+		else if(arg == "--tournament-size")
+			settings.selection.tournament_size = std::size_t(std::atol(value.c_str()));
+		else if(arg == "--rank-pressure")
+			settings.selection.rank_pressure = float(std::atof(value.c_str()));
+		else if(arg == "--selection" && value == "roulette")
+			settings.selection.method = SelectionSettings::Roulette;
+		else if(arg == "--selection" && value == "sus")
+			settings.selection.method = SelectionSettings::StochasticUniversal;
+		else if(arg == "--selection" && value == "tournament")
+			settings.selection.method = SelectionSettings::Tournament;
+		else if(arg == "--selection" && value == "rank")
+			settings.selection.method = SelectionSettings::Rank;
+		else if(arg == "--report")
+			report_interval = std::size_t(std::atol(value.c_str()));
+		else if(arg == "--mode" && (value == "batched" || value == "entity"))
+			settings.evaluation.mode = value == "batched"? EvaluationSettings::Batched : EvaluationSettings::PerEntity;
+		else if(arg == "--aggregation" && value == "mean")
+			settings.evaluation.aggregation = EvaluationSettings::Mean;
+		else if(arg == "--aggregation" && value == "min")
+			settings.evaluation.aggregation = EvaluationSettings::Min;
+		else if(arg == "--aggregation" && value == "quantile")
+			settings.evaluation.aggregation = EvaluationSettings::Quantile;
+		else
+			return false;
+	}
+
+	return settings.population_size > 0 && settings.corpus_size > 0 && report_interval > 0;
+}
+
+
+int main( int argc, char** argv )
+{
+	TrainingSettings settings;
+	std::size_t report_interval = 1;
+	if(!ParseArguments(argc, argv, settings, report_interval))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	try
+	{
+		ConsoleObserver observer(report_interval);
+		AiTest test(settings, &observer);
+		std::cout << "training with seed " << test.seed() << std::endl;
+		test.run();
+	}catch(const std::exception& e)
+	{
+		std::cerr << "ai-train: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,211 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <stdexcept>
+#include "tick_reader.hpp"
+#include "chart_file.hpp"
+
+
+// Imports csv or line based tick files into a chart file.
+// Every input file becomes one chart. The files are streamed twice, the first pass finds the
+// value range, the second normalizes the values into [min, max] and writes them, so the memory
+// usage does not depend on the size of the files.
+
+#define VALUE_BUFFER_SIZE	(64 * 1024)
+
+
+struct ImportSettings
+{
+	ImportSettings()
+		: min_value(0.0f)
+		, max_value(10.0f)
+		, tick_rate(0.0f)
+		, chunk_size(1 << 20)
+	{
+	}
+
+	TickFormat format;
+	float min_value;
+	float max_value;
+	float tick_rate;
+	std::size_t chunk_size;
+	std::string output;
+	std::vector<std::string> inputs;
+};
+
+struct ImportStats
+{
+	ImportStats()
+		: bytes(0)
+		, seconds(0.0)
+	{
+	}
+
+	void add(std::uint64_t pass_bytes, double pass_seconds)
+	{
+		bytes += pass_bytes;
+		seconds += pass_seconds;
+	}
+
+	double mb_per_sec() const
+	{
+		return seconds > 0.0? double(bytes) / (1024.0 * 1024.0) / seconds : 0.0;
+	}
+
+	std::uint64_t bytes;
+	double seconds;
+};
+
+
+static double SecondsSince( std::chrono::high_resolution_clock::time_point start )
+{
+	using namespace std::chrono;
+	return duration_cast<duration<double>>(high_resolution_clock::now() - start).count();
+}
+
+
+static void ImportFile( const std::string& path, const ImportSettings& settings, ChartFileWriter& writer, ImportStats& scan_stats, ImportStats& write_stats )
+{
+	TickReader reader(path, settings.format, settings.chunk_size);
+	std::vector<float> values(VALUE_BUFFER_SIZE);
+
+	// first pass: range of the file
+	auto start = std::chrono::high_resolution_clock::now();
+	float low = std::numeric_limits<float>::max();
+	float high = std::numeric_limits<float>::lowest();
+	std::uint64_t tick_count = 0;
+	while(std::size_t count = reader.read(values.data(), values.size()))
+	{
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			low = std::min(low, values[i]);
+			high = std::max(high, values[i]);
+		}
+		tick_count += count;
+	}
+	const double scan_seconds = SecondsSince(start);
+	scan_stats.add(reader.bytes_read(), scan_seconds);
+
+	if(tick_count == 0)
+		throw std::runtime_error("'" + path + "' contains no values");
+
+	// second pass: normalize and write
+	reader.rewind();
+	start = std::chrono::high_resolution_clock::now();
+	const float range = high - low;
+	const float scale = range > 0.0f? (settings.max_value - settings.min_value) / range : 0.0f;
+	const float offset = range > 0.0f? settings.min_value : (settings.min_value + settings.max_value) * 0.5f;
+
+	writer.begin_chart(settings.min_value, settings.max_value, settings.tick_rate);
+	while(std::size_t count = reader.read(values.data(), values.size()))
+	{
+		for(std::size_t i = 0; i < count; ++i)
+			values[i] = offset + (values[i] - low) * scale;
+		writer.append(values.data(), count);
+	}
+	writer.end_chart();
+	const double write_seconds = SecondsSince(start);
+	write_stats.add(reader.bytes_read(), write_seconds);
+
+	std::cout << path << ": " << tick_count << " ticks in [" << low << ", " << high << "], "
+		<< reader.skipped_lines() << " lines skipped, "
+		<< (scan_seconds > 0.0? double(reader.bytes_read()) / (1024.0 * 1024.0) / scan_seconds : 0.0) << " MB/s scan, "
+		<< (write_seconds > 0.0? double(reader.bytes_read()) / (1024.0 * 1024.0) / write_seconds : 0.0) << " MB/s write"
+		<< std::endl;
+}
+
+
+static void PrintUsage()
+{
+	std::cerr << "usage: chart-import [options] <output> <inputs...>\n"
+		<< "  --column N      column of the value, negative counts from the end (default -1)\n"
+		<< "  --delimiter C   column delimiter (default ',')\n"
+		<< "  --skip N        lines to skip at the beginning of every file (default 0)\n"
+		<< "  --min V         lower bound of the normalized values (default 0)\n"
+		<< "  --max V         upper bound of the normalized values (default 10)\n"
+		<< "  --tick-rate R   ticks per second stored with the charts (default 0 = unknown)\n"
+		<< "  --chunk-size B  bytes read at once, also the maximal line length (default 1048576)\n";
+}
+
+static bool ParseArguments( int argc, char** argv, ImportSettings& settings )
+{
+	std::vector<std::string> files;
+	for(int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if(arg.compare(0, 2, "--") != 0)
+		{
+			files.push_back(arg);
+			continue;
+		}
+
+		if(i + 1 >= argc)
+			return false;
+		const std::string value = argv[++i];
+
+		if(arg == "--column")
+			settings.format.column = std::atoi(value.c_str());
+		else if(arg == "--delimiter")
+			settings.format.delimiter = value == "\\t"? '\t' : value[0];
+		else if(arg == "--skip")
+			settings.format.skip_lines = std::size_t(std::atol(value.c_str()));
+		else if(arg == "--min")
+			settings.min_value = float(std::atof(value.c_str()));
+		else if(arg == "--max")
+			settings.max_value = float(std::atof(value.c_str()));
+		else if(arg == "--tick-rate")
+			settings.tick_rate = float(std::atof(value.c_str()));
+		else if(arg == "--chunk-size")
+			settings.chunk_size = std::size_t(std::atol(value.c_str()));
+		else
+			return false;
+	}
+
+	if(files.size() < 2 || settings.chunk_size == 0 || settings.min_value >= settings.max_value)
+		return false;
+
+	settings.output = files.front();
+	settings.inputs.assign(files.begin() + 1, files.end());
+	return true;
+}
+
+
+int main( int argc, char** argv )
+{
+	ImportSettings settings;
+	if(!ParseArguments(argc, argv, settings))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	ImportStats scan_stats;
+	ImportStats write_stats;
+	try
+	{
+		ChartFileWriter writer(settings.output, settings.inputs.size());
+		for(const std::string& input : settings.inputs)
+			ImportFile(input, settings, writer, scan_stats, write_stats);
+		writer.close();
+	}catch(const std::exception& e)
+	{
+		// do not leave a half written chart file behind
+		std::remove(settings.output.c_str());
+		std::cerr << "chart-import: " << e.what() << std::endl;
+		return 1;
+	}
+
+	ImportStats total;
+	total.add(scan_stats.bytes + write_stats.bytes, scan_stats.seconds + write_stats.seconds);
+	std::cout << settings.inputs.size() << " charts written to " << settings.output << ", "
+		<< scan_stats.mb_per_sec() << " MB/s scan, "
+		<< write_stats.mb_per_sec() << " MB/s write, "
+		<< total.mb_per_sec() << " MB/s total" << std::endl;
+
+	return 0;
+}